@@ -28,6 +28,18 @@ typedef signed int         SInt;
 typedef unsigned int       UInt;
 typedef unsigned long long ULongLong;
 
+/* counts that can pass ULongLong_MAX where the compiler has 128 bit 
+   integers (gcc and clang on 64 bit targets), elsewhere they are taken 
+   modulo 2^64 and the engines using them accept fewer graphs */
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128  UHugeInt;
+#define UHugeInt_BIT 128
+#else
+typedef ULongLong          UHugeInt;
+#define UHugeInt_BIT 64
+#endif
+
 /* macro to ease error recovering malloc assignments */
 
 #define EM(val, len, e_dest) if (!(val=malloc(len))) goto e_dest
@@ -344,6 +344,26 @@ write_usignedbigval_str(char * buf, ULongLong x)
     return l;
 }
 
+
+/*! Digits are made in reverse in a scratch buffer, there is no length
+table for 39 digits. */
+
+int
+write_usignedhugeval_str(char * buf, UHugeInt x)
+{
+    char d[MAX_UHugeInt_STR_LEN];
+    int  l = 0, i;
+    
+    do {
+        d[l++] = (char)('0' + (int)(x % 10));
+        x /= 10;
+    } while (x);
+    
+    for (i = 0; i < l; i++) buf[i] = d[l - 1 - i];
+    
+    return l;
+} /* write_usignedhugeval_str */
+
 /* right justified writing IO */
 
 inline int
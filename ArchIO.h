@@ -50,6 +50,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define MAX_ULongLong_STR_LEN 20
 #endif
 
+#define MAX_UHugeInt_STR_LEN 39
+
 #define RJUST_OVERFLOW_CHAR 'X'
 
 int get_usigned_dec_length(const UInt x);
@@ -63,6 +65,7 @@ bool read_usignedbigval(FILE *inp, ULongLong *xptr);
 int write_signedval_str(char * buf, SInt x);
 int write_usignedval_str(char * buf, UInt x);
 int write_usignedbigval_str(char * buf, ULongLong x);
+int write_usignedhugeval_str(char * buf, UHugeInt x);
 
 int write_rj_signedval_str(char * buf, int len, char pad,
   SInt x);
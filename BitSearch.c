@@ -0,0 +1,452 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "Timer.h"
+#include "BitSet.h"
+#include "TapeBudget.h"
+#include "BitSearch.h"
+
+/* NOTES:
+
+For graphs of at most 64 vertices the set of neighbours of each vertex 
+is a 64 bit word, vertex x being bit x - 1, so a test against a whole 
+vertex set is one and, and no state is allocated per graph.
+
+Dense graphs small enough for a table of all vertex subsets are solved 
+by the Held-Karp recurrence over the subsets S of the vertices other 
+than a start vertex s: a decision keeps for each S the word of vertices
+v in S such that some path from s covers S and ends at v, so that one 
+and tests every end at once; a count keeps the number of those paths 
+for each end.
+
+Every other graph is searched by growing a path from s.  Its first 
+vertex f is the lower of the cycle neighbours of s, so each cycle is 
+met once.  Before extending the path to cur the unvisited vertices are
+checked:
+
+  - each needs two neighbours among the unvisited vertices, cur and s,
+  - one with just two, one of them cur, must come next (two such end 
+    the branch),
+  - all must be reached from cur through unvisited vertices,
+  - one of them must be a neighbour of s above f to close the cycle,
+  
+and a vertex both of whose remaining edges are forced may not share a 
+neighbour with two others.
+
+The tape engine is faster than the path search on sparse graphs, where
+its segments force much more, so the tools use countBySubsets and 
+decideBySubsets: the tape engine is run for about as long as the table
+would take, and the table is filled only when it has not finished by 
+then.  A graph of 18 vertices and 78 edges has 171229198 cycles, about
+five minutes of tape rotations and 0.07 seconds of table. */
+
+/* countByBits and decideByBits give dense graphs, of average degree 
+   above HC_BITS_DENSE, to the subset tables.  A decision first searches
+   paths for one extension per HC_BITS_PATH_CELLS table words, which 
+   settles most Hamiltonian graphs at once. */
+
+#define HC_BITS_DENSE          4
+#define HC_BITS_PATH_CELLS    16
+
+/* a tape rotation costs about as much as this many table cells */
+
+#define HC_BITS_ROTATION_CELLS 32
+
+/* path extensions between readings of the clock */
+
+#define HC_BITS_CLOCK_MASK    4095
+
+typedef struct bit_search {
+    UInt        pts;
+    BitSet      adj[HC_BITS_MAX_VERTICES];
+    UInt        start;
+    BitSet      last;       /* neighbours of start that may close */
+    bool        decide;
+    ULongLong   cycles;
+    ULongLong   nodes;
+    ULongLong   limit;      /* path extensions allowed, 0 for any */
+    double      deadline;   /* monotonic time limit, 0 for none */
+    bool        stopped;
+} BitSearch;
+
+
+/*! Set up b for g, false when g has fewer than 3 vertices or one of 
+degree < 2. */
+
+static bool
+loadBits(BitSearch *b, Graph *g, bool decide, double seconds)
+{
+    b->pts      = g->vertex_count;
+    b->decide   = decide;
+    b->cycles   = 0;
+    b->nodes    = 0;
+    b->stopped  = false;
+    b->limit    = 0;
+    b->deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    /* start at a vertex of least degree, fewest first vertices */
+    
+    return loadBitSets(g, b->adj, &b->start) && b->pts >= 3;
+    
+} /* loadBits */
+
+
+static bool
+clockExpired(BitSearch *b)
+{
+    if (b->deadline && monotonicSeconds() >= b->deadline) 
+        b->stopped = true;
+    return b->stopped;
+} /* clockExpired */
+
+
+/*! Extend the path ending at cur over the unvisited vertices left. */
+
+static void
+extendPath(BitSearch *b, UInt cur, BitSet left)
+{
+    BitSet   avail, forced, once, twice, next, reach, front, nb, e;
+    UInt     u;
+    
+    BitSet  *adj = b->adj;
+    
+    if (!left) {
+        if (b->last & BIT(cur)) b->cycles++;
+        return;
+    }
+    
+    if (++b->nodes == b->limit) {
+        b->stopped = true;
+        return;
+    }
+    if (!(b->nodes & HC_BITS_CLOCK_MASK) && clockExpired(b)) return;
+    if (!(b->last & left)) return;
+    
+    /* the closing edge at s is open to the vertices of last only */
+    
+    avail  = left | BIT(cur);
+    forced = once = twice = 0;
+    
+    for (nb = left; nb; nb &= nb - 1) {
+        u = lowestBit(nb);
+        e = adj[u] & avail;
+        if (b->last & BIT(u)) e |= BIT(b->start);
+        
+        switch (bitCount(e)) {
+        case 0:
+        case 1:
+            return;
+        case 2:
+            
+            /* both edges of u are forced, no vertex takes three and the
+               ends of the path take one each */
+            
+            if (twice & e) return;
+            twice |= once & e;
+            once  |= e;
+            if (e & BIT(cur)) {
+                if (e & BIT(b->start) && left != BIT(u)) return;
+                forced = BIT(u);
+            }
+        }
+    }
+    if (twice & (BIT(cur) | BIT(b->start))) return;
+    
+    /* the unvisited vertices must hang together from cur */
+    
+    reach = front = adj[cur] & left;
+    while (front) {
+        nb = 0;
+        for (; front; front &= front - 1) nb |= adj[lowestBit(front)];
+        front  = nb & left & ~reach;
+        reach |= front;
+    }
+    if (reach != left) return;
+    
+    for (next = forced ? forced : adj[cur] & left; next; next &= next - 1) {
+        u = lowestBit(next);
+        extendPath(b, u, left & ~BIT(u));
+        if (b->stopped || (b->decide && b->cycles)) return;
+    }
+    
+} /* extendPath */
+
+
+static HCSearchStatus
+searchPaths(BitSearch *b)
+{
+    BitSet   first, all;
+    UInt     f;
+    
+    UInt     s = b->start;
+    
+    all = b->pts == 64 ? ~(BitSet)0 : BIT(b->pts) - 1;
+    
+    for (first = b->adj[s]; first; first &= first - 1) {
+        f       = lowestBit(first);
+        b->last = b->adj[s] & ~((BIT(f) << 1) - 1);
+        extendPath(b, f, all & ~BIT(s) & ~BIT(f));
+        if (b->stopped) return HC_SEARCH_UNDECIDED;
+        if (b->decide && b->cycles) return HC_SEARCH_CYCLE;
+    }
+    
+    return b->cycles ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+} /* searchPaths */
+
+
+/*! The neighbour words of the k = n - 1 vertices other than the start,
+renumbered 0..k-1, and the word of the neighbours of the start. */
+
+static BitSet
+tableBits(BitSearch *b, BitSet *adj)
+{
+    BitSet   x, low;
+    UInt     v;
+    
+    UInt     s = b->start;
+    
+    /* dropping bit s shifts the bits above it down by one */
+    
+    low = BIT(s) - 1;
+    for (v = 0; v < b->pts; v++) {
+        x = b->adj[v];
+        x = (x & low) | ((x >> 1) & ~low);
+        if (v < s) adj[v] = x;
+        else if (v > s) adj[v - 1] = x;
+    }
+    x = b->adj[s];
+    
+    return (x & low) | ((x >> 1) & ~low);
+    
+} /* tableBits */
+
+
+static HCSearchStatus
+decideByTable(BitSearch *b, Status *st)
+{
+    BitSet   adj[HC_BITS_MAX_VERTICES], ends, rest, *reach, S, full, sa;
+    UInt     w;
+    
+    UInt     k = b->pts - 1;
+    
+    sa   = tableBits(b, adj);
+    full = BIT(k) - 1;
+    
+    EM(reach, (full + 1) * sizeof(BitSet), e0);
+    memset(reach, 0, (full + 1) * sizeof(BitSet));
+    
+    for (rest = sa; rest; rest &= rest - 1) 
+        reach[rest & -rest] = rest & -rest;
+    
+    for (S = 1; S < full; S++) {
+        if (!(ends = reach[S])) continue;
+        if (!(S & HC_BITS_CLOCK_MASK) && clockExpired(b)) break;
+        
+        for (rest = full & ~S; rest; rest &= rest - 1) {
+            w = lowestBit(rest);
+            if (adj[w] & ends) reach[S | BIT(w)] |= BIT(w);
+        }
+    }
+    
+    b->cycles = reach[full] & sa ? 1 : 0;
+    free(reach);
+    
+    if (b->stopped) return HC_SEARCH_UNDECIDED;
+    return b->cycles ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* decideByTable */
+
+
+static HCSearchStatus
+countByTable(BitSearch *b, Status *st)
+{
+    BitSet     adj[HC_BITS_MAX_VERTICES], rest, next, S, full, sa;
+    ULongLong *paths, c, *row;
+    UInt       v, w;
+    
+    UInt       k = b->pts - 1;
+    
+    sa   = tableBits(b, adj);
+    full = BIT(k) - 1;
+    
+    EM(paths, (full + 1) * k * sizeof(ULongLong), e0);
+    memset(paths, 0, (full + 1) * k * sizeof(ULongLong));
+    
+    for (rest = sa; rest; rest &= rest - 1) {
+        v = lowestBit(rest);
+        paths[BIT(v) * k + v] = 1;
+    }
+    
+    for (S = 1; S < full; S++) {
+        if (!(S & HC_BITS_CLOCK_MASK) && clockExpired(b)) break;
+        
+        row = paths + S * k;
+        for (rest = S; rest; rest &= rest - 1) {
+            v = lowestBit(rest);
+            if (!(c = row[v])) continue;
+            
+            for (next = adj[v] & full & ~S; next; next &= next - 1) {
+                w = lowestBit(next);
+                paths[(S | BIT(w)) * k + w] += c;
+            }
+        }
+    }
+    
+    /* each cycle is a path closed in both directions */
+    
+    row = paths + full * k;
+    for (rest = sa; rest; rest &= rest - 1) b->cycles += row[lowestBit(rest)];
+    b->cycles /= 2;
+    free(paths);
+    
+    if (b->stopped) {
+        b->cycles = 0;
+        return HC_SEARCH_UNDECIDED;
+    }
+    return b->cycles ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* countByTable */
+
+
+/*! Subset tables for dense graphs that fit them, else the path search. */
+
+HCSearchStatus
+countByBits(Graph *g, ULongLong *cycles, double seconds, Status *status)
+{
+    BitSearch       b;
+    HCSearchStatus  r;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count > HC_BITS_MAX_VERTICES) return HC_SEARCH_UNDECIDED;
+    if (!loadBits(&b, g, false, seconds)) return HC_SEARCH_EXHAUSTED;
+    
+    if (b.pts <= HC_BITS_COUNT_TABLE && 
+        2 * g->edge_count > HC_BITS_DENSE * b.pts) 
+        r = countByTable(&b, status);
+    else 
+        r = searchPaths(&b);
+    
+    *cycles = b.cycles;
+    return r;
+    
+} /* countByBits */
+
+
+HCSearchStatus
+decideByBits(Graph *g, double seconds, Status *status)
+{
+    BitSearch       b;
+    HCSearchStatus  r;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count > HC_BITS_MAX_VERTICES) return HC_SEARCH_UNDECIDED;
+    if (!loadBits(&b, g, true, seconds)) return HC_SEARCH_EXHAUSTED;
+    
+    if (b.pts > HC_BITS_DECIDE_TABLE || 
+        2 * g->edge_count <= HC_BITS_DENSE * b.pts) return searchPaths(&b);
+    
+    b.limit = BIT(b.pts - 1) / HC_BITS_PATH_CELLS + 1;
+    if ((r = searchPaths(&b)) != HC_SEARCH_UNDECIDED) return r;
+    
+    b.stopped = false;
+    if (clockExpired(&b)) return HC_SEARCH_UNDECIDED;
+    return decideByTable(&b, status);
+    
+} /* decideByBits */
+
+
+/*! The table of the BitSearch in arg, the fallback of searchSubsets. */
+
+static HCSearchStatus
+tableAfterTape(Graph *g, void *arg, bool decide, double seconds, 
+               UHugeInt *cycles, Status *st)
+{
+    BitSearch      *b = (BitSearch *)arg;
+    HCSearchStatus  r;
+    
+    r = decide ? decideByTable(b, st) : countByTable(b, st);
+    *cycles = b->cycles;
+    return r;
+    
+} /* tableAfterTape */
+
+
+/*! Run the tape engine for budget rotations, then fill the table. */
+
+static HCSearchStatus
+searchSubsets(Graph *g, bool decide, bool prune, double seconds, 
+              ULongLong *c, Status *st)
+{
+    HCSearchStatus  result;
+    BitSearch       b;
+    UHugeInt        cycles;
+    ULongLong       budget;
+    UInt            k;
+    
+    *c = 0;
+    
+    CHECK_RETURN_VAL(*st, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count > 
+          (decide ? HC_BITS_DECIDE_TABLE : HC_BITS_COUNT_TABLE)) 
+        return HC_SEARCH_UNDECIDED;
+    if (!loadBits(&b, g, decide, seconds)) return HC_SEARCH_EXHAUSTED;
+    
+    k      = b.pts - 1;
+    budget = (decide ? BIT(k) : BIT(k) * k) / HC_BITS_ROTATION_CELLS + 1;
+    
+    result = searchTapeThen(g, decide, prune, seconds, budget, 
+                            tableAfterTape, &b, &cycles, st);
+    *c = (ULongLong)cycles;
+    return result;
+    
+} /* searchSubsets */
+
+
+HCSearchStatus
+countBySubsets(Graph *g, ULongLong *cycles, bool prune, double seconds,
+               Status *status)
+{
+    return searchSubsets(g, false, prune, seconds, cycles, status);
+} /* countBySubsets */
+
+
+HCSearchStatus
+decideBySubsets(Graph *g, bool prune, double seconds, Status *status)
+{
+    ULongLong c;
+    
+    return searchSubsets(g, true, prune, seconds, &c, status);
+} /* decideBySubsets */
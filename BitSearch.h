@@ -0,0 +1,55 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef BITSEARCH_H
+#define BITSEARCH_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/* the bit engines take graphs of at most HC_BITS_MAX_VERTICES vertices,
+   the subset tables those of at most HC_BITS_COUNT_TABLE vertices for 
+   counting (2^(n-1) (n-1) counts) and HC_BITS_DECIDE_TABLE for deciding
+   (2^(n-1) words) */
+
+#define HC_BITS_MAX_VERTICES   64
+#define HC_BITS_COUNT_TABLE    20
+#define HC_BITS_DECIDE_TABLE   22
+
+/* count the Hamilton cycles of g, or decide if there is one, with the
+   adjacency of each vertex held in a machine word.  HC_SEARCH_UNDECIDED
+   is returned when the time limit is reached (seconds, 0 for none) or g
+   is too large. */
+HCSearchStatus countByBits(Graph *g, ULongLong *cycles, double seconds, 
+                           Status *status);
+HCSearchStatus decideByBits(Graph *g, double seconds, Status *status);
+
+/* the tape engine first, for as many rotations as the subset table would
+   cost, then the table if the tape has not finished: graphs with few 
+   cycles stay as fast as with the tape alone and dense ones cost about 
+   one table.  For graphs within the table sizes above. */
+HCSearchStatus countBySubsets(Graph *g, ULongLong *cycles, bool prune,
+                              double seconds, Status *status);
+HCSearchStatus decideBySubsets(Graph *g, bool prune, double seconds, 
+                               Status *status);
+
+#endif /* BITSEARCH_H */
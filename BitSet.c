@@ -0,0 +1,77 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+#include "Arch.h"
+#include "Graph.h"
+#include "BitSet.h"
+
+
+#if !defined(__GNUC__)
+
+UInt
+bitCount(BitSet x)
+{
+    UInt c = 0;
+    
+    for (; x; x &= x - 1) c++;
+    return c;
+    
+} /* bitCount */
+
+
+UInt
+lowestBit(BitSet x)
+{
+    UInt i = 0;
+    
+    for (; !(x & 1); x >>= 1) i++;
+    return i;
+    
+} /* lowestBit */
+
+#endif
+
+
+bool
+loadBitSets(Graph *g, BitSet *adj, UInt *start)
+{
+    Arc     *a;
+    Vertex   x;
+    UInt     low = UInt_MAX;
+    
+    *start = 0;
+    
+    for (x = 1; x <= (Vertex)g->vertex_count; x++) {
+        adj[x - 1] = 0;
+        for (a = g->adj_lists[x]; a; a = a->next) 
+            adj[x - 1] |= BIT(a->target - 1);
+        
+        if (g->degree[x] < 2) return false;
+        if (g->degree[x] < low) {
+            low    = g->degree[x];
+            *start = x - 1;
+        }
+    }
+    
+    return true;
+    
+} /* loadBitSets */
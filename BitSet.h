@@ -0,0 +1,55 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+
+#ifndef BITSET_H
+#define BITSET_H
+
+#include "Arch.h"
+#include "Graph.h"
+
+/* a set of the vertices of a graph of at most BITSET_MAX_VERTICES 
+   vertices in one word, vertex x being bit x - 1 */
+
+#define BITSET_MAX_VERTICES 64
+
+typedef ULongLong BitSet;
+
+#define BIT(x)  ((BitSet)1 << (x))
+
+/* the size of a set and the index of its lowest vertex (the set is not
+   empty) */
+
+#if defined(__GNUC__)
+#define bitCount(x)   ((UInt)__builtin_popcountll(x))
+#define lowestBit(x)  ((UInt)__builtin_ctzll(x))
+#else
+UInt bitCount(BitSet x);
+UInt lowestBit(BitSet x);
+#endif
+
+/* the neighbour sets of the vertices of g into adj, and into *start the
+   index of the first vertex of least degree.  false when a vertex has 
+   degree less than 2. */
+bool loadBitSets(Graph *g, BitSet *adj, UInt *start);
+
+#endif /* BITSET_H */
@@ -310,3 +310,366 @@ Vertex x, SInt *c, bool inSepSet)
     return cp || diff > 0;
 } /* getComponentDiff */
 
+
+/*! Work arrays of the low point dfs, allocated once for the many searches
+of the cut finders. */
+
+typedef struct low_point {
+    UInt    *visit, *low, *size;
+    Vertex  *stack, *parent;
+    Arc    **iter, **tree;
+    UInt     pts;
+} LowPoint;
+
+
+static bool
+allocateLowPoint(LowPoint *w, UInt pts, Status *st)
+{
+    UInt     n = pts + 1;
+    
+    CHECK_RETURN_VAL(*st, false);
+    
+    w->pts = pts;
+    
+    EM(w->visit,  n * sizeof(UInt),   e0);
+    EM(w->low,    n * sizeof(UInt),   e1);
+    EM(w->size,   n * sizeof(UInt),   e2);
+    EM(w->stack,  n * sizeof(Vertex), e3);
+    EM(w->parent, n * sizeof(Vertex), e4);
+    EM(w->iter,   n * sizeof(Arc *),  e5);
+    EM(w->tree,   n * sizeof(Arc *),  e6);
+    
+    return true;
+    
+e6: free(w->iter);
+e5: free(w->parent);
+e4: free(w->stack);
+e3: free(w->size);
+e2: free(w->low);
+e1: free(w->visit);
+e0: *st = STATUS_NO_MEM;
+    return false;
+    
+} /* allocateLowPoint */
+
+
+static void
+releaseLowPoint(LowPoint *w)
+{
+    free(w->tree);
+    free(w->iter);
+    free(w->parent);
+    free(w->stack);
+    free(w->size);
+    free(w->low);
+    free(w->visit);
+} /* releaseLowPoint */
+
+
+static inline bool
+isBanned(Arc *a, Arc **ban, UInt nban)
+{
+    while (nban--) if (a == ban[nban] || a->cross == ban[nban]) return true;
+    return false;
+} /* isBanned */
+
+
+/*! Non-recursive low point dfs of g without vertex skip and the nban 
+edges of ban, from the lowest remaining vertex.  A vertex other than the
+root is a cut vertex when a child cannot reach above it, the root when it
+has two children; a tree arc is a bridge when its child cannot reach its
+source or above.  The part a cut vertex or bridge separates is measured 
+by the smaller side, counted from the subtree it cuts off, and the most 
+balanced cut vertex and bridge are returned with their smaller sides in 
+*cutSide and *bridgeSide.  Returns the number of vertices reached. */
+
+static UInt
+lowPointSearch(LowPoint *w, Arc **L, Vertex skip, Arc **ban, UInt nban,
+               Vertex *cut, UInt *cutSide, Arc **bridge, UInt *bridgeSide)
+{
+    Arc     *a;
+    Vertex   x, y, p;
+    UInt     s, side;
+    
+    UInt    *visit    = w->visit;
+    UInt    *low      = w->low;
+    UInt    *size     = w->size;
+    Vertex  *stack    = w->stack;
+    Vertex  *parent   = w->parent;
+    Arc    **iter     = w->iter;
+    Arc    **tree     = w->tree;
+    UInt     total    = w->pts - (skip != 0);
+    Vertex   root     = skip == 1 ? 2 : 1;
+    UInt     count    = 0;
+    UInt     children = 0;
+    UInt     first    = 0;
+    UInt     sp       = 0;
+    
+    *cut       = 0;
+    *bridge    = NULL;
+    *cutSide   = *bridgeSide = 0;
+    
+    if (root > w->pts) return 0;
+    
+    memset(visit, 0, (w->pts + 1) * sizeof(UInt));
+    if (skip) visit[skip] = w->pts + 1;
+    
+    visit[root] = low[root] = ++count;
+    parent[root] = 0;
+    iter[root]   = L[root];
+    stack[sp++]  = root;
+    
+    while (sp) {
+        x = stack[sp - 1];
+        
+        if ((a = iter[x])) {
+        
+            /* descend along the next arc of x */
+            
+            iter[x] = a->next;
+            y       = a->target;
+            
+            if (y == skip || (nban && isBanned(a, ban, nban))) continue;
+            
+            if (!visit[y]) {
+                visit[y]    = low[y] = ++count;
+                parent[y]   = x;
+                tree[y]     = a;
+                iter[y]     = L[y];
+                stack[sp++] = y;
+                if (x == root) children++;
+            } else if (y != parent[x] && visit[y] < low[x]) {
+                low[x] = visit[y];
+            }
+            continue;
+        }
+        
+        /* x is done, pass its low point up to its parent */
+        
+        sp--;
+        size[x] = count - visit[x] + 1;
+        if (!(p = parent[x])) continue;
+        
+        if (low[x] < low[p]) low[p] = low[x];
+        
+        s = size[x];
+        if (p == root && !first) first = s;
+        
+        if (low[x] > visit[p]) {
+            side = s < total - s ? s : total - s;
+            if (side > *bridgeSide) {
+                *bridge     = tree[x];
+                *bridgeSide = side;
+            }
+        }
+        if (p != root && low[x] >= visit[p]) {
+            side = s < total - 1 - s ? s : total - 1 - s;
+            if (side > *cutSide || !*cut) {
+                *cut     = p;
+                *cutSide = side;
+            }
+        }
+    }
+    
+    if (children > 1) {
+        side = first < total - 1 - first ? first : total - 1 - first;
+        if (side > *cutSide || !*cut) {
+            *cut     = root;
+            *cutSide = side;
+        }
+    }
+    
+    return count;
+    
+} /* lowPointSearch */
+
+
+/*! One low point dfs of g. */
+
+Vertex
+findCutVertex(Graph *g, Arc **bridge, bool *connected, Status *st)
+{
+    LowPoint w;
+    Vertex   cut;
+    UInt     cutSide, bridgeSide, reached;
+    
+    *bridge    = NULL;
+    *connected = true;
+    
+    if (!g->vertex_count || !allocateLowPoint(&w, g->vertex_count, st)) 
+        return 0;
+    
+    reached = lowPointSearch(&w, g->adj_lists, 0, NULL, 0, 
+                             &cut, &cutSide, bridge, &bridgeSide);
+    *connected = reached == g->vertex_count;
+    
+    releaseLowPoint(&w);
+    
+    return cut;
+    
+} /* findCutVertex */
+
+
+/*! A cut vertex of g - u gives the separation pair {u, v}.  One low 
+point dfs per vertex u keeps the pair with the largest smaller side. */
+
+bool
+findSeparationPair(Graph *g, UInt min, Vertex *u, Vertex *v, Status *st)
+{
+    LowPoint w;
+    Arc     *bridge;
+    Vertex   x, cut;
+    UInt     cutSide, bridgeSide;
+    
+    UInt     best = 0;
+    
+    *u = *v = 0;
+    
+    if (g->vertex_count < 4 || !allocateLowPoint(&w, g->vertex_count, st)) 
+        return false;
+    
+    for (x = 1; x <= g->vertex_count; x++) {
+        lowPointSearch(&w, g->adj_lists, x, NULL, 0, 
+                       &cut, &cutSide, &bridge, &bridgeSide);
+        
+        if (cut && cutSide >= min && cutSide > best) {
+            best = cutSide;
+            *u   = x;
+            *v   = cut;
+        }
+    }
+    
+    releaseLowPoint(&w);
+    
+    return best > 0;
+    
+} /* findSeparationPair */
+
+
+/*! Mark in side the vertices reached from x without crossing the k cut 
+edges, returning how many there are, or 0 if a cut edge has both ends 
+on one side (the cut is not minimal). */
+
+static UInt
+markCutSide(Graph *g, Arc **cut, UInt k, Vertex *stack, bool *side)
+{
+    Arc     *a;
+    Vertex   x, y;
+    UInt     i;
+    
+    UInt     sp = 0;
+    UInt     n  = 1;
+    
+    memset(side, 0, (g->vertex_count + 1) * sizeof(bool));
+    
+    x = cut[0]->target;
+    side[x]     = true;
+    stack[sp++] = x;
+    
+    while (sp) {
+        x = stack[--sp];
+        for (a = g->adj_lists[x]; a; a = a->next) {
+            y = a->target;
+            if (side[y] || isBanned(a, cut, k)) continue;
+            side[y]     = true;
+            stack[sp++] = y;
+            n++;
+        }
+    }
+    
+    for (i = 0; i < k; i++) 
+        if (side[cut[i]->target] == side[cut[i]->cross->target]) return 0;
+    
+    return n;
+    
+} /* markCutSide */
+
+
+/*! Try the cut made of the n edges of ban and a bridge of g without 
+them, keeping it in best when its smaller side is the largest yet. */
+
+static void
+tryEdgeCut(Graph *g, LowPoint *w, Arc **ban, UInt n, UInt min, bool *side,
+           Arc **best, UInt *bestSide, UInt *bestSize)
+{
+    Arc     *cut[3], *bridge;
+    Vertex   c;
+    UInt     cutSide, bridgeSide, s;
+    
+    UInt     pts = g->vertex_count;
+    
+    lowPointSearch(w, g->adj_lists, 0, ban, n, 
+                   &c, &cutSide, &bridge, &bridgeSide);
+    
+    if (!bridge || bridgeSide < min || bridgeSide <= *bestSide) return;
+    
+    /* check the cut and measure its sides exactly */
+    
+    cut[0] = bridge;
+    cut[1] = ban[0];
+    cut[2] = n > 1 ? ban[1] : NULL;
+    
+    s = markCutSide(g, cut, n + 1, w->stack, side);
+    if (s > pts - s) s = pts - s;
+    if (s < min || s <= *bestSide) return;
+    
+    memcpy(best, cut, sizeof(cut));
+    *bestSide = s;
+    *bestSize = n + 1;
+    
+} /* tryEdgeCut */
+
+
+/*! An edge cut of 2 edges is a bridge of g less one edge, one of 3 edges
+a bridge of g less two.  Every choice is tried and the cut whose smaller
+side is largest is kept, 3 edge cuts only when there is no 2 edge cut.
+g must have no bridge so the cuts found are minimal. */
+
+UInt
+findSmallEdgeCut(Graph *g, UInt min, Arc **cut, bool *side, Status *st)
+{
+    LowPoint w;
+    Arc    **edges, *ban[2], *a;
+    Vertex   x;
+    UInt     m, i, j;
+    bool     twoEdges;
+    
+    UInt     pts  = g->vertex_count;
+    UInt     best = 0;
+    UInt     size = 0;
+    
+    if (pts < 4 || !allocateLowPoint(&w, pts, st)) return 0;
+    
+    EM(edges, (g->edge_count + 1) * sizeof(Arc *), e0);
+    
+    for (m = 0, x = 1; x <= pts; x++) 
+        for (a = g->adj_lists[x]; a; a = a->next) 
+            if (a->target > x) edges[m++] = a;
+    
+    for (i = 0; i < m; i++) {
+        ban[0] = edges[i];
+        tryEdgeCut(g, &w, ban, 1, min, side, cut, &best, &size);
+    }
+    twoEdges = size != 0;
+    
+    for (i = 0; i < m && !twoEdges; i++) {
+        for (j = i + 1; j < m; j++) {
+            ban[0] = edges[i];
+            ban[1] = edges[j];
+            tryEdgeCut(g, &w, ban, 2, min, side, cut, &best, &size);
+        }
+    }
+    
+    /* side was overwritten by the cuts tried after the best one */
+    
+    if (size) markCutSide(g, cut, size, w.stack, side);
+    
+    free(edges);
+    releaseLowPoint(&w);
+    return size;
+    
+e0: releaseLowPoint(&w);
+    *st = STATUS_NO_MEM;
+    return 0;
+    
+} /* findSmallEdgeCut */
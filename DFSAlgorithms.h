@@ -45,5 +45,25 @@ bool
 getComponentDiff(HCDFSRef dfs, Arc **L, Vertex *e, UInt *d, Vertex *nv, 
 Vertex x, SInt *c, bool inSepSet);
 
+/* return a cut vertex of g, or 0 if there is none, and in *bridge an arc
+of a bridge or NULL.  *connected tells if every vertex was reached. */
+
+Vertex
+findCutVertex(Graph *g, Arc **bridge, bool *connected, Status *st);
+
+
+/* return true with a separation pair {u,v} of g, the pair whose removal 
+leaves the largest smaller part, with at least min vertices in each. */
+
+bool
+findSeparationPair(Graph *g, UInt min, Vertex *u, Vertex *v, Status *st);
+
+/* return the size (2 or 3, 0 if none) of the edge cut of g, stored in 
+cut, whose smaller side is largest and has at least min vertices.  
+side[x] (n+1 entries) is set for vertices on the side of cut[0]->target.
+g should have no bridge. */
+
+UInt
+findSmallEdgeCut(Graph *g, UInt min, Arc **cut, bool *side, Status *st);
 
 #endif /* _DFSALGORITHMS_H_ */
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Arch.h"
 #include "Graph.h"
+#include "Random.h"
 
 /* remove arc from adjacency list */
 inline void 
@@ -67,6 +68,28 @@ insertArc(Arc **Lx, Arc *nx)
     
 } /* insert_arc */
 
+/*! Put the arcs of the list Lx in a random order.  buf must have room for
+every arc of the list. */
+
+void
+shuffleArcs(Arc **Lx, Arc **buf, RandomState *r)
+{
+    Arc    *a, *t;
+    UInt    c, j;
+    
+    for (c = 0, a = *Lx; a; a = a->next) buf[c++] = a;
+    
+    *Lx = NULL;
+    
+    while (c) {
+        j      = randomBelow(r, c--);
+        t      = buf[j];
+        buf[j] = buf[c];
+        insertArc(Lx, t);
+    }
+    
+} /* shuffleArcs */
+
 Graph *
 allocateGraph(char *name, UInt pts, Status *status)
 {
@@ -244,6 +267,129 @@ releaseGraph(Graph *g)
 
 
 
+/*! Create a private copy of g with the same labels and edges. */
+
+Graph *
+copyGraph(Graph *g, Status *st)
+{
+    Graph   *h;
+    Arc     *a;
+    Vertex   x, y;
+    
+    Vertex   pts = g->vertex_count;
+    
+    h = initGraph(allocateGraph(g->name, pts, st));
+    if (!h) return NULL;
+    
+    for (x = 1; x <= pts; x++) {
+        for (a = g->adj_lists[x]; a; a = a->next) {
+            y = a->target;
+            if (y >= x) continue;
+            if ((*st = createEdge(h, x, y)) != STATUS_OK) {
+                releaseGraph(h);
+                return NULL;
+            }
+        }
+    }
+    
+    return h;
+    
+} /* copyGraph */
+
+
+/*! Create a copy of g where vertex order->array[i] is relabeled i+1.
+Edges are created in order of their new labels so that the arcs of
+vertices with nearby labels are allocated near each other. */
+
+Graph *
+relabelGraph(Graph *g, VArray *order, Status *st)
+{
+    Graph   *h;
+    Arc     *a;
+    Vertex  *lbl, x, y;
+    
+    Vertex   pts = g->vertex_count;
+    
+    EM(lbl, (pts + 1) * sizeof(Vertex), e0);
+    
+    for (x = 1; x <= pts; x++) lbl[order->array[x-1]] = x;
+    
+    h = initGraph(allocateGraph(g->name, pts, st));
+    if (!h) goto e1;
+    
+    for (x = 1; x <= pts; x++) {
+        for (a = g->adj_lists[order->array[x-1]]; a; a = a->next) {
+            y = lbl[a->target];
+            if (y >= x) continue;
+            if ((*st = createEdge(h, x, y)) != STATUS_OK) goto e2;
+        }
+    }
+    
+    free(lbl);
+    return h;
+    
+e2: releaseGraph(h);
+e1: free(lbl);
+    return NULL;
+    
+e0: *st = STATUS_NO_MEM;
+    return NULL;
+    
+} /* relabelGraph */
+
+
+
+/*! Write the end pairs of the edges of g to edges (2 * edge_count
+entries), lower end first, ordered by lower end and then by upper end,
+so that edgeIndex can find an edge by binary search. */
+
+void
+listEdges(Graph *g, Vertex *edges)
+{
+    Arc     *a;
+    Vertex   x;
+    UInt     i, f, m = 0;
+    
+    for (x = 1; x <= (Vertex)g->vertex_count; x++) {
+        f = m;
+        for (a = g->adj_lists[x]; a; a = a->next) {
+            if (a->target < x) continue;
+            for (i = m++; i > f && edges[2*i-1] > a->target; i--) {
+                edges[2*i]   = x;
+                edges[2*i+1] = edges[2*i-1];
+            }
+            edges[2*i]   = x;
+            edges[2*i+1] = a->target;
+        }
+    }
+    
+} /* listEdges */
+
+
+
+/*! Index of the edge xy in the m edges listed by listEdges. */
+
+UInt
+edgeIndex(Vertex *edges, UInt m, Vertex x, Vertex y)
+{
+    UInt    lo = 0, hi = m, mid;
+    Vertex  t;
+    
+    if (x > y) { t = x; x = y; y = t; }
+    
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (edges[2*mid] < x || (edges[2*mid] == x && edges[2*mid+1] < y)) 
+            lo = mid + 1;
+        else hi = mid;
+    }
+    
+    return lo;
+    
+} /* edgeIndex */
+
+
+
 /*! Clear adjacency matrix. */
 
 void 
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define GRAPH_H
 
 #include "Arch.h"
+#include "Random.h"
 
 #define GRAPH_MAX_POINTS         100000
 #define GRAPH_MAX_TITLE_LENGTH   120
@@ -113,10 +114,17 @@ void releaseVArray(VArray *va);
 
 void insertArc(Arc **Lx, Arc *nx);
 void removeArc(Arc **Lx, Arc *nx);
+void shuffleArcs(Arc **Lx, Arc **buf, RandomState *r);
 
 Status createEdge(Graph *g, Vertex x, Vertex y);
 Status createEdges(Graph *g, VArray *l, Vertex x);
 
+Graph *copyGraph(Graph *g, Status *st);
+Graph *relabelGraph(Graph *g, VArray *order, Status *st);
+
+void listEdges(Graph *g, Vertex *edges);
+UInt edgeIndex(Vertex *edges, UInt m, Vertex x, Vertex y);
+
 void releaseGraph(Graph *g);
 void resetAdjmatrix(bool **M, UInt pts);
 
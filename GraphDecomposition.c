@@ -0,0 +1,461 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "DFSAlgorithms.h"
+#include "HamiltonianCycle.h"
+#include "GraphDecomposition.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+
+/* NOTES:
+
+A Hamilton cycle crosses an edge cut an even number of times, at least 
+twice.  Across a cut of 2 edges it uses both, across one of 3 edges 
+exactly 2, and on each side it is then a Hamilton path between the ends
+of the two edges used.  The Hamilton paths of side A from a to b are the
+Hamilton cycles of A with one new vertex joined to a and b, which stands
+for the other side.  So
+
+    cycles(G) = sum over the pairs {i,j} of cut edges used of 
+                cycles(A + w_ij) * cycles(B + w_ij).
+
+Removing a separation pair {u,v} leaves components of which a Hamilton
+cycle, split at u and v into two u-v paths, can cover at most two.  With
+two components C1 and C2
+
+    cycles(G) = cycles(C1 + u + v + w) * cycles(C2 + u + v + w)
+
+with w joined to u and v.  The pieces are split again in turn.  With at
+least 2 vertices on each side of a cut every piece is smaller than the 
+graph, the rest are searched with the tape engine. */
+
+/* vertices on each side of a cut, with fewer a piece is as large as 
+   the graph */
+
+#define DECOMPOSE_MIN_SIDE   2
+
+/* an edge cut is used only when its smaller side has at least 1/4 of the
+   vertices, the sides of a 3 edge cut are solved up to three times each 
+   and splitting off a few vertices costs more than it saves */
+
+#define DECOMPOSE_BALANCE    4
+
+/* graphs smaller than this are searched without looking for cuts */
+
+#define DECOMPOSE_MIN_GRAPH  20
+
+struct hc_decomposition {
+    bool        prune;      /* search pieces with pruning */
+    double      deadline;   /* monotonic time limit, 0 for none */
+    HCDecompositionStatistics stats;
+};
+
+static HCSearchStatus
+solve(HCDecompositionRef d, Graph *g, bool decide, ULongLong *c, 
+      Status *st);
+
+
+HCDecompositionRef
+allocateDecomposition(Status *status)
+{
+    HCDecompositionRef d;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    EM(d, sizeof(struct hc_decomposition), e0);
+    
+    return initDecomposition(d, false, 0);
+    
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocateDecomposition */
+
+
+HCDecompositionRef
+initDecomposition(HCDecompositionRef d, bool prune, double seconds)
+{
+    if (!d) return NULL;
+    
+    d->prune    = prune;
+    d->deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    memset(&d->stats, 0, sizeof(HCDecompositionStatistics));
+    
+    return d;
+    
+} /* initDecomposition */
+
+
+void
+releaseDecomposition(HCDecompositionRef d)
+{
+    free(d);
+} /* releaseDecomposition */
+
+
+/*! The graph on the vertices x of g with label[x] != 0, numbered 
+label[x], with one more vertex joined to a and b. */
+
+static Graph *
+buildPiece(Graph *g, Vertex *label, UInt pts, Vertex a, Vertex b, 
+           Status *st)
+{
+    Graph  *h;
+    Arc    *e;
+    Vertex  x, y;
+    
+    if (!(h = initGraph(allocateGraph(g->name, pts + 1, st)))) return NULL;
+    
+    for (x = 1; x <= g->vertex_count; x++) {
+        if (!label[x]) continue;
+        for (e = g->adj_lists[x]; e; e = e->next) {
+            y = e->target;
+            if (label[y] && y < x &&
+                (*st = createEdge(h, label[x], label[y])) != STATUS_OK) 
+                goto e0;
+        }
+    }
+    
+    if ((*st = createEdge(h, pts + 1, label[a])) != STATUS_OK) goto e0;
+    if ((*st = createEdge(h, pts + 1, label[b])) != STATUS_OK) goto e0;
+    
+    return h;
+    
+e0: releaseGraph(h);
+    return NULL;
+    
+} /* buildPiece */
+
+
+/*! Solve the piece of g on the labeled vertices, closed by a new vertex 
+joined to a and b. */
+
+static HCSearchStatus
+solvePiece(HCDecompositionRef d, Graph *g, Vertex *label, UInt pts, 
+           Vertex a, Vertex b, bool decide, ULongLong *c, Status *st)
+{
+    Graph          *h;
+    HCSearchStatus  result;
+    
+    *c = 0;
+    
+    if (!(h = buildPiece(g, label, pts, a, b, st))) 
+        return HC_SEARCH_UNDECIDED;
+    
+    result = solve(d, h, decide, c, st);
+    releaseGraph(h);
+    
+    return result;
+    
+} /* solvePiece */
+
+
+/*! Number the vertices x of g with side[x] == in from 1, the others 0,
+returning how many were numbered. */
+
+static UInt
+labelSide(Graph *g, bool *side, bool in, Vertex *label)
+{
+    Vertex  x;
+    UInt    n = 0;
+    
+    for (x = 1; x <= g->vertex_count; x++) 
+        label[x] = side[x] == in ? ++n : 0;
+    
+    return n;
+    
+} /* labelSide */
+
+
+/*! Combine the sides of the edge cut of k edges over every pair of cut
+edges a Hamilton cycle can use. */
+
+static HCSearchStatus
+splitEdgeCut(HCDecompositionRef d, Graph *g, Arc **cut, UInt k, 
+             bool *side, bool decide, ULongLong *c, Status *st)
+{
+    Vertex  in[3], out[3], *labelA, *labelB;
+    ULongLong ca, cb;
+    UInt    i, j, na, nb;
+    
+    UInt    n      = g->vertex_count + 1;
+    HCSearchStatus result = HC_SEARCH_EXHAUSTED;
+    
+    *c = 0;
+    
+    EM(labelA, n * sizeof(Vertex), e0);
+    EM(labelB, n * sizeof(Vertex), e1);
+    
+    d->stats.edgeCuts++;
+    
+    for (i = 0; i < k; i++) {
+        in[i]  = cut[i]->target;
+        out[i] = cut[i]->cross->target;
+        if (!side[in[i]]) {
+            in[i]  = out[i];
+            out[i] = cut[i]->target;
+        }
+    }
+    
+    na = labelSide(g, side, true,  labelA);
+    nb = labelSide(g, side, false, labelB);
+    
+    for (i = 0; i < k && result != HC_SEARCH_UNDECIDED; i++) {
+        for (j = i + 1; j < k; j++) {
+            
+            /* a side entered and left at one vertex is a single vertex */
+            
+            if (in[i] == in[j] || out[i] == out[j]) continue;
+            
+            result = solvePiece(d, g, labelA, na, in[i], in[j], 
+                                decide, &ca, st);
+            if (result == HC_SEARCH_UNDECIDED) break;
+            if (!ca) continue;
+            
+            result = solvePiece(d, g, labelB, nb, out[i], out[j], 
+                                decide, &cb, st);
+            if (result == HC_SEARCH_UNDECIDED) break;
+            
+            *c += ca * cb;
+            if (decide && *c) break;
+        }
+        if (decide && *c) break;
+    }
+    
+    free(labelB);
+    free(labelA);
+    
+    if (result == HC_SEARCH_UNDECIDED) return result;
+    return *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e1: free(labelA);
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* splitEdgeCut */
+
+
+/*! Combine the two components left by removing u and v. */
+
+static HCSearchStatus
+splitVertexCut(HCDecompositionRef d, Graph *g, Vertex u, Vertex v, 
+               bool decide, ULongLong *c, Status *st)
+{
+    Arc    *a;
+    Vertex *comp, *stack, *label, x, y, r;
+    ULongLong cp;
+    UInt    m, i, np, sp;
+    
+    UInt    pts    = g->vertex_count;
+    UInt    n      = pts + 1;
+    HCSearchStatus result = HC_SEARCH_EXHAUSTED;
+    
+    *c = 0;
+    
+    EM(comp,  n * sizeof(Vertex), e0);
+    EM(stack, n * sizeof(Vertex), e1);
+    EM(label, n * sizeof(Vertex), e2);
+    
+    d->stats.vertexCuts++;
+    
+    /* number the components of g - u - v */
+    
+    memset(comp, 0, n * sizeof(Vertex));
+    comp[u] = comp[v] = -1;
+    
+    for (m = 0, r = 1; r <= pts; r++) {
+        if (comp[r]) continue;
+        comp[r]  = ++m;
+        stack[0] = r;
+        sp       = 1;
+        while (sp) {
+            x = stack[--sp];
+            for (a = g->adj_lists[x]; a; a = a->next) {
+                y = a->target;
+                if (comp[y]) continue;
+                comp[y]     = m;
+                stack[sp++] = y;
+            }
+        }
+    }
+    
+    /* the two u-v paths of a cycle cover at most two components */
+    
+    for (i = 1; i <= m && m == 2; i++) {
+        for (np = 0, x = 1; x <= pts; x++) 
+            label[x] = comp[x] == (Vertex)i || comp[x] < 0 ? ++np : 0;
+        
+        result = solvePiece(d, g, label, np, u, v, decide, &cp, st);
+        if (result == HC_SEARCH_UNDECIDED) break;
+        
+        *c = i == 1 ? cp : *c * cp;
+        if (!*c) break;
+    }
+    
+    free(label);
+    free(stack);
+    free(comp);
+    
+    if (result == HC_SEARCH_UNDECIDED) return result;
+    return *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e2: free(stack);
+e1: free(comp);
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* splitVertexCut */
+
+
+/*! Count, or decide, the Hamilton cycles of a piece with no cut left. */
+
+static HCSearchStatus
+searchPiece(HCDecompositionRef d, Graph *g, bool decide, ULongLong *c, 
+            Status *st)
+{
+    HCStateRef      hc;
+    VArray         *vo;
+    HCSearchStatus  result;
+    bool            found;
+    double          seconds = 0;
+    
+    *c = 0;
+    
+    if (d->deadline) {
+        seconds = d->deadline - monotonicSeconds();
+        if (seconds <= 0) return HC_SEARCH_UNDECIDED;
+    }
+    
+    d->stats.pieces++;
+    if (g->vertex_count > d->stats.largest) 
+        d->stats.largest = g->vertex_count;
+    
+    vo = sortVerticesDegreeDesc(
+            initVArray(allocateVArray(g->vertex_count, st)), g->degree);
+    hc = allocateHCState(g->vertex_count, st);
+    if (*st != STATUS_OK) {
+        if (vo) releaseVArray(vo);
+        if (hc) releaseHCState(hc);
+        return HC_SEARCH_UNDECIDED;
+    }
+    
+    initHCState(hc, g->degree, g->adj_lists, vo);
+    setHCSearchLimits(hc, 0, seconds);
+    
+    found = d->prune ? firstHamiltonianCycleWithPruning(hc)
+                     : firstHamiltonianCycle(hc);
+    if (found) (*c)++;
+    
+    if (!decide && found) {
+        while (d->prune ? nextHamiltonianCycleWithPruning(hc)
+                        : nextHamiltonianCycle(hc)) (*c)++;
+    }
+    
+    result = getHCSearchStatus(hc);
+    if (result != HC_SEARCH_UNDECIDED) 
+        result = *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+    releaseHCState(hc);
+    releaseVArray(vo);
+    
+    return result;
+    
+} /* searchPiece */
+
+
+/*! Split g along the cut with the most even sides, or search it when 
+there is none.  In a decision *c is 1 or 0. */
+
+static HCSearchStatus
+solve(HCDecompositionRef d, Graph *g, bool decide, ULongLong *c, 
+      Status *st)
+{
+    Arc    *bridge, *cut[3];
+    Vertex  u, v;
+    bool   *side, connected;
+    UInt    k, min;
+    HCSearchStatus result;
+    
+    *c = 0;
+    
+    CHECK_RETURN_VAL(*st, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count < 3) return HC_SEARCH_EXHAUSTED;
+    
+    if (findCutVertex(g, &bridge, &connected, st) || bridge || !connected)
+        return *st == STATUS_OK ? HC_SEARCH_EXHAUSTED : HC_SEARCH_UNDECIDED;
+    
+    if (g->vertex_count >= DECOMPOSE_MIN_GRAPH) {
+        
+        if (findSeparationPair(g, DECOMPOSE_MIN_SIDE, &u, &v, st)) 
+            return splitVertexCut(d, g, u, v, decide, c, st);
+        
+        EM(side, (g->vertex_count + 1) * sizeof(bool), e0);
+        
+        min = g->vertex_count / DECOMPOSE_BALANCE;
+        if (min < DECOMPOSE_MIN_SIDE) min = DECOMPOSE_MIN_SIDE;
+        
+        if ((k = findSmallEdgeCut(g, min, cut, side, st))) {
+            result = splitEdgeCut(d, g, cut, k, side, decide, c, st);
+            free(side);
+            return result;
+        }
+        free(side);
+    }
+    
+    CHECK_RETURN_VAL(*st, HC_SEARCH_UNDECIDED);
+    
+    return searchPiece(d, g, decide, c, st);
+    
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* solve */
+
+
+HCSearchStatus
+countByDecomposition(HCDecompositionRef d, Graph *g, ULongLong *cycles, 
+                     Status *status)
+{
+    return solve(d, g, false, cycles, status);
+} /* countByDecomposition */
+
+
+HCSearchStatus
+decideByDecomposition(HCDecompositionRef d, Graph *g, Status *status)
+{
+    ULongLong c;
+    
+    return solve(d, g, true, &c, status);
+} /* decideByDecomposition */
+
+
+void
+getDecompositionStatistics(HCDecompositionRef d, 
+                           HCDecompositionStatistics *st)
+{
+    *st = d->stats;
+} /* getDecompositionStatistics */
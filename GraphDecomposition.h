@@ -0,0 +1,59 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef GRAPHDECOMPOSITION_H
+#define GRAPHDECOMPOSITION_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/*! Work done splitting a graph, see getDecompositionStatistics. */
+
+typedef struct hc_decomposition_statistics {
+    UInt  edgeCuts;     /*!< splits along a 2 or 3 edge cut            */
+    UInt  vertexCuts;   /*!< splits along a 2 vertex cut               */
+    UInt  pieces;       /*!< graphs searched with the tape engine      */
+    UInt  largest;      /*!< vertices of the largest piece searched    */
+} HCDecompositionStatistics;
+
+typedef struct hc_decomposition * HCDecompositionRef;  /* opaque type */
+
+HCDecompositionRef allocateDecomposition(Status *status);
+
+/* pieces are searched with pruning when prune is set, a search stops 
+   after seconds (0 for no limit) */
+HCDecompositionRef initDecomposition(HCDecompositionRef d, bool prune, 
+                                     double seconds);
+void releaseDecomposition(HCDecompositionRef d);
+
+/* count the Hamilton cycles of g, or decide if there is one, splitting 
+   it along small cuts and searching the pieces.  HC_SEARCH_UNDECIDED is
+   returned when the time limit is reached. */
+HCSearchStatus countByDecomposition(HCDecompositionRef d, Graph *g, 
+                                    ULongLong *cycles, Status *status);
+HCSearchStatus decideByDecomposition(HCDecompositionRef d, Graph *g, 
+                                     Status *status);
+
+void getDecompositionStatistics(HCDecompositionRef d, 
+                                HCDecompositionStatistics *st);
+
+#endif /* GRAPHDECOMPOSITION_H */
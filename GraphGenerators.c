@@ -0,0 +1,324 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "Random.h"
+#include "GraphGenerators.h"
+
+/* pairings tried by randomRegularGraph before giving up */
+
+#define REGULAR_ATTEMPTS 1000
+
+
+/*! Allocate an empty graph on pts vertices titled by a printf format. */
+
+static Graph *
+namedGraph(UInt pts, Status *st, const char *fmt, UInt a, UInt b)
+{
+    char name[GRAPH_MAX_TITLE_LENGTH];
+    
+    snprintf(name, sizeof(name), fmt, a, b);
+    return initGraph(allocateGraph(name, pts, st));
+    
+} /* namedGraph */
+
+
+/*! Add the edge xy, releasing g on failure. */
+
+static bool
+addEdge(Graph **g, Vertex x, Vertex y, Status *st)
+{
+    if ((*st = createEdge(*g, x, y)) == STATUS_OK) return true;
+    
+    releaseGraph(*g);
+    *g = NULL;
+    return false;
+    
+} /* addEdge */
+
+
+/*! Generalized Petersen graph GP(n,k), outer cycle 1..n with spokes to
+the inner vertices n+1..2n, inner vertex i joined to i+k (mod n). 
+Requires n >= 3 and 1 <= k < n/2. */
+
+Graph *
+generalizedPetersenGraph(UInt n, UInt k, Status *st)
+{
+    Graph   *g;
+    UInt     i;
+    
+    CHECK_RETURN_VAL(*st, NULL);
+    
+    if (n < 3 || k < 1 || 2 * k >= n) {
+        *st = STATUS_INVALID_INPUT;
+        return NULL;
+    }
+    
+    if (!(g = namedGraph(2 * n, st, "GP(%u,%u)", n, k))) return NULL;
+    
+    for (i = 0; i < n; i++) {
+        if (!addEdge(&g, i + 1, (i + 1) % n + 1, st)
+             || !addEdge(&g, i + 1, n + i + 1, st)
+             || !addEdge(&g, n + i + 1, n + (i + k) % n + 1, st)) 
+            return NULL;
+    }
+    
+    return g;
+    
+} /* generalizedPetersenGraph */
+
+
+/*! The hypohamiltonian generalized Petersen graph GP(6k+5,2), the 
+Petersen graph for k = 0.  It has no Hamilton cycle but every vertex
+deleted subgraph does, a worst case for the search. */
+
+Graph *
+hypohamiltonianGraph(UInt k, Status *st)
+{
+    return generalizedPetersenGraph(6 * k + 5, 2, st);
+} /* hypohamiltonianGraph */
+
+
+/*! The rows x cols grid graph, vertex (r,c) is r*cols + c + 1. */
+
+Graph *
+gridGraph(UInt rows, UInt cols, Status *st)
+{
+    Graph   *g;
+    UInt     r, c;
+    Vertex   x;
+    
+    CHECK_RETURN_VAL(*st, NULL);
+    
+    if (!rows || !cols) {
+        *st = STATUS_INVALID_INPUT;
+        return NULL;
+    }
+    
+    if (!(g = namedGraph(rows * cols, st, "Grid %ux%u", rows, cols))) 
+        return NULL;
+    
+    for (r = 0; r < rows; r++) {
+        for (c = 0; c < cols; c++) {
+            x = r * cols + c + 1;
+            if (c + 1 < cols && !addEdge(&g, x, x + 1, st))    return NULL;
+            if (r + 1 < rows && !addEdge(&g, x, x + cols, st)) return NULL;
+        }
+    }
+    
+    return g;
+    
+} /* gridGraph */
+
+
+/*! Moebius ladder on 2*rungs vertices, the cycle 1..2*rungs with each 
+vertex joined to the opposite one.  Requires rungs >= 2. */
+
+Graph *
+moebiusLadderGraph(UInt rungs, Status *st)
+{
+    Graph   *g;
+    UInt     i;
+    UInt     n = 2 * rungs;
+    
+    CHECK_RETURN_VAL(*st, NULL);
+    
+    if (rungs < 2) {
+        *st = STATUS_INVALID_INPUT;
+        return NULL;
+    }
+    
+    if (!(g = namedGraph(n, st, "Moebius ladder %u", rungs, 0))) 
+        return NULL;
+    
+    for (i = 0; i < n; i++) {
+        if (!addEdge(&g, i + 1, (i + 1) % n + 1, st)) return NULL;
+        if (i < rungs && !addEdge(&g, i + 1, i + rungs + 1, st)) 
+            return NULL;
+    }
+    
+    return g;
+    
+} /* moebiusLadderGraph */
+
+
+/*! A random simple k-regular graph on n vertices from the pairing model,
+points are paired at random and a pairing that would create a loop or a
+multiple edge is retried, restarting when stuck.  Requires n*k even and
+k < n.  The same generator state always gives the same graph. */
+
+Graph *
+randomRegularGraph(UInt n, UInt k, RandomState *r, Status *st)
+{
+    Graph   *g;
+    Vertex  *pt, x, y;
+    UInt     i, j, t, left, attempt, stuck;
+    
+    CHECK_RETURN_VAL(*st, NULL);
+    
+    if (k >= n || k < 1 || (n * k) % 2) {
+        *st = STATUS_INVALID_INPUT;
+        return NULL;
+    }
+    
+    EM(pt, n * k * sizeof(Vertex), e0);
+    
+    for (attempt = 0; attempt < REGULAR_ATTEMPTS; attempt++) {
+    
+        g = namedGraph(n, st, "Random %u-regular %u", k, n);
+        if (!g) goto e1;
+        
+        for (i = 0; i < n * k; i++) pt[i] = i / k + 1;
+        
+        left  = n * k;
+        stuck = 0;
+        
+        while (left && stuck < 100) {
+        
+            i = randomBelow(r, left);
+            j = randomBelow(r, left);
+            x = pt[i];
+            y = pt[j];
+            
+            if (x == y || g->adj_matrix[x][y]) {
+                stuck++;
+                continue;
+            }
+            
+            if (!addEdge(&g, x, y, st)) goto e1;
+            
+            /* drop both points, the larger index first */
+            
+            if (i < j) {
+                t = i;
+                i = j;
+                j = t;
+            }
+            
+            pt[i] = pt[--left];
+            pt[j] = pt[--left];
+            stuck = 0;
+        }
+        
+        if (!left) {
+            free(pt);
+            return g;
+        }
+        
+        releaseGraph(g);
+    }
+    
+    *st = STATUS_INVALID_INPUT;
+    
+e1: free(pt);
+    return NULL;
+    
+e0: *st = STATUS_NO_MEM;
+    return NULL;
+    
+} /* randomRegularGraph */
+
+
+/*! A random geometric graph, n points placed uniformly in the unit square
+and joined when at most radius apart. */
+
+Graph *
+randomGeometricGraph(UInt n, double radius, RandomState *r, Status *st)
+{
+    Graph   *g;
+    double  *px, *py, dx, dy;
+    UInt     i, j;
+    
+    CHECK_RETURN_VAL(*st, NULL);
+    
+    EM(px, n * sizeof(double), e0);
+    EM(py, n * sizeof(double), e1);
+    
+    g = namedGraph(n, st, "Geometric %u r%u", n, (UInt)(radius * 100 + 0.5));
+    if (!g) goto e2;
+    
+    for (i = 0; i < n; i++) {
+        px[i] = randomUnit(r);
+        py[i] = randomUnit(r);
+    }
+    
+    for (i = 0; i < n; i++) {
+        for (j = i + 1; j < n; j++) {
+            dx = px[i] - px[j];
+            dy = py[i] - py[j];
+            if (dx * dx + dy * dy <= radius * radius 
+                 && !addEdge(&g, i + 1, j + 1, st)) goto e2;
+        }
+    }
+    
+    free(py);
+    free(px);
+    return g;
+    
+e2: free(py);
+    free(px);
+    return NULL;
+    
+e1: free(px);
+e0: *st = STATUS_NO_MEM;
+    return NULL;
+    
+} /* randomGeometricGraph */
+
+
+/*! Build a graph of the family named "gp" (GP(a,b)), "hypo" (GP(6a+5,2)),
+"regular" (a vertices, degree b), "grid" (a x b), "moebius" (a rungs) or
+"geometric" (a points within radius).  Random families draw from a 
+generator seeded with seed mixed with the parameters, so each graph of a
+suite differs and stays the same when other graphs are added. */
+
+Graph *
+generateGraph(char *family, UInt a, UInt b, double radius, ULongLong seed,
+    Status *st)
+{
+    RandomState r;
+    
+    seedRandom(&r, seed + 1000003ULL * a + 1009ULL * b 
+                        + (ULongLong)(radius * 1e6));
+    
+    if (!strcmp(family, "gp"))        
+        return generalizedPetersenGraph(a, b, st);
+    if (!strcmp(family, "hypo"))      
+        return hypohamiltonianGraph(a, st);
+    if (!strcmp(family, "regular"))   
+        return randomRegularGraph(a, b, &r, st);
+    if (!strcmp(family, "grid"))      
+        return gridGraph(a, b, st);
+    if (!strcmp(family, "moebius"))   
+        return moebiusLadderGraph(a, st);
+    if (!strcmp(family, "geometric")) 
+        return randomGeometricGraph(a, radius, &r, st);
+    
+    *st = STATUS_INVALID_INPUT;
+    return NULL;
+    
+} /* generateGraph */
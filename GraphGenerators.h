@@ -0,0 +1,41 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef GRAPHGENERATORS_H
+#define GRAPHGENERATORS_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "Random.h"
+
+/* parameterized graph families, built in memory for benchmarking.
+   Each returns NULL and sets *st on failure. */
+
+Graph *generalizedPetersenGraph(UInt n, UInt k, Status *st);
+Graph *hypohamiltonianGraph(UInt k, Status *st);
+Graph *gridGraph(UInt rows, UInt cols, Status *st);
+Graph *moebiusLadderGraph(UInt rungs, Status *st);
+Graph *randomRegularGraph(UInt n, UInt k, RandomState *r, Status *st);
+Graph *randomGeometricGraph(UInt n, double radius, RandomState *r, 
+                            Status *st);
+Graph *generateGraph(char *family, UInt a, UInt b, double radius, 
+                     ULongLong seed, Status *st);
+
+#endif /* GRAPHGENERATORS_H */
@@ -0,0 +1,527 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "DFSAlgorithms.h"
+#include "GraphReduction.h"
+
+/* NOTES:
+
+An edge is *forced* when one of its ends has degree 2, every Hamilton 
+cycle uses it.  The rules, applied until none changes the graph:
+
+1/ a vertex of degree < 2 has no Hamilton cycle through it.
+
+2/ a vertex with three forced edges has no Hamilton cycle through it, 
+   one with two forced edges uses no other edge, those are removed.
+
+3/ forced edges that close a cycle shorter than the graph leave no 
+   Hamilton cycle, an edge joining the ends of a path of forced edges 
+   would close such a cycle and is removed.
+
+A graph that survives must be connected and 2-connected, so a cut vertex 
+or bridge also shows there is no Hamilton cycle.  Each run of 2 or more 
+degree 2 vertices between vertices of higher degree is then contracted 
+to its first vertex, which keeps the number of Hamilton cycles. */
+
+struct hc_kernel {
+    Graph      *graph;    /* kernel graph, NULL until reduced */
+    const char *reason;   /* why there is no Hamilton cycle, or NULL */
+    UInt        pts;      /* vertices of the original graph */
+    Vertex     *orig;     /* original vertex of each kernel vertex */
+    Vertex     *from;     /* kernel neighbour a chain starts at, or 0 */
+    UInt       *first;    /* offset of the chain of each kernel vertex */
+    UInt       *length;   /* vertices of the original graph it stands for */
+    Vertex     *chain;    /* original vertices, in order along chains */
+    HCKernelStatistics stats;
+};
+
+
+HCKernelRef
+allocateKernel(Status *status)
+{
+    HCKernelRef k;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    EM(k, sizeof(struct hc_kernel), e0);
+    
+    k->graph = NULL;
+    k->orig  = k->from = k->chain = NULL;
+    k->first = k->length = NULL;
+    
+    return initKernel(k);
+    
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocateKernel */
+
+
+/*! Drop the result of the last reduction. */
+
+HCKernelRef
+initKernel(HCKernelRef k)
+{
+    if (!k) return NULL;
+    
+    if (k->graph) releaseGraph(k->graph);
+    free(k->orig);
+    free(k->from);
+    free(k->first);
+    free(k->length);
+    free(k->chain);
+    
+    k->graph  = NULL;
+    k->orig   = k->from = k->chain = NULL;
+    k->first  = k->length = NULL;
+    k->reason = NULL;
+    k->pts    = 0;
+    
+    memset(&k->stats, 0, sizeof(HCKernelStatistics));
+    
+    return k;
+    
+} /* initKernel */
+
+
+void
+releaseKernel(HCKernelRef k)
+{
+    if (!k) return;
+    
+    initKernel(k);
+    free(k);
+    
+} /* releaseKernel */
+
+
+/*! Remove the edge xy from h and free its arcs. */
+
+static void
+deleteEdge(Graph *h, Vertex x, Vertex y)
+{
+    Arc    *a;
+    Arc   **L = h->adj_lists;
+    
+    for (a = L[x]; a->target != y; a = a->next);
+    
+    removeArc(L + x, a);
+    removeArc(L + y, a->cross);
+    free(a->cross);
+    free(a);
+    
+    h->adj_matrix[x][y] = h->adj_matrix[y][x] = false;
+    h->degree[x]--;
+    h->degree[y]--;
+    h->edge_count--;
+    
+} /* deleteEdge */
+
+
+/*! Number of forced edges at x. */
+
+static inline UInt
+forcedDegree(Graph *h, Vertex x)
+{
+    Arc    *a;
+    UInt    f = 0;
+    UInt   *d = h->degree;
+    
+    if (d[x] == 2) return 2;
+    for (a = h->adj_lists[x]; a; a = a->next) if (d[a->target] == 2) f++;
+    
+    return f;
+    
+} /* forcedDegree */
+
+
+/*! The forced neighbour of x other than p, 0 if there is none. */
+
+static inline Vertex
+nextForced(Graph *h, Vertex x, Vertex p)
+{
+    Arc    *a;
+    UInt   *d = h->degree;
+    
+    for (a = h->adj_lists[x]; a; a = a->next) {
+        if (a->target != p && (d[x] == 2 || d[a->target] == 2)) 
+            return a->target;
+    }
+    return 0;
+    
+} /* nextForced */
+
+
+/*! One round of rules 1 to 3, returns true if an edge was removed.  
+Sets k->reason when the graph has no Hamilton cycle. */
+
+static bool
+applyRules(HCKernelRef k, Graph *h, bool *seen)
+{
+    Arc    *a, *b;
+    Vertex  x, y, p, q;
+    UInt    f, len;
+    
+    UInt   *d       = h->degree;
+    UInt    pts     = h->vertex_count;
+    bool    changed = false;
+    
+    k->stats.passes++;
+    
+    for (x = 1; x <= pts; x++) {
+        if (d[x] < 2) {
+            k->reason = "vertex of degree less than 2";
+            return false;
+        }
+        if (d[x] == 2 || (f = forcedDegree(h, x)) < 2) continue;
+        
+        if (f > 2) {
+            k->reason = "vertex with three forced edges";
+            return false;
+        }
+        
+        /* both cycle edges of x are known, drop the rest */
+        
+        for (a = h->adj_lists[x]; a; a = b) {
+            b = a->next;
+            if (d[a->target] != 2) {
+                deleteEdge(h, x, a->target);
+                k->stats.removedEdges++;
+                changed = true;
+            }
+        }
+        if (d[x] < 2) {
+            k->reason = "vertex of degree less than 2";
+            return false;
+        }
+    }
+    
+    if (changed) return true;
+    
+    /* walk the paths of forced edges from their ends */
+    
+    memset(seen, 0, (pts + 1) * sizeof(bool));
+    
+    for (x = 1; x <= pts; x++) {
+        if (seen[x] || forcedDegree(h, x) != 1) continue;
+        
+        len = 1;
+        p   = 0;
+        y   = x;
+        seen[x] = true;
+        while ((q = nextForced(h, y, p))) {
+            p = y;
+            y = q;
+            seen[y] = true;
+            len++;
+        }
+        
+        if (len < pts && h->adj_matrix[x][y]) {
+            deleteEdge(h, x, y);
+            k->stats.removedEdges++;
+            changed = true;
+        }
+    }
+    
+    if (changed) return true;
+    
+    /* what remains of the forced edges are cycles */
+    
+    for (x = 1; x <= pts; x++) {
+        if (seen[x] || d[x] != 2) continue;
+        
+        len = 1;
+        p   = 0;
+        y   = x;
+        seen[x] = true;
+        while ((q = nextForced(h, y, p)) && q != x) {
+            p = y;
+            y = q;
+            seen[y] = true;
+            len++;
+        }
+        
+        if (len < pts) {
+            k->reason = "forced edges close a short cycle";
+            return false;
+        }
+    }
+    
+    return false;
+    
+} /* applyRules */
+
+
+/*! Build the kernel graph from the reduced copy h, contracting each run
+of 2 or more degree 2 vertices into its first vertex. */
+
+static Graph *
+contractChains(HCKernelRef k, Graph *h, Vertex *label, Status *st)
+{
+    Graph  *g;
+    Arc    *a;
+    Vertex  x, y, p, q, r;
+    UInt    c;
+    
+    UInt   *d    = h->degree;
+    UInt    pts  = h->vertex_count;
+    UInt    kpts = 0;
+    UInt    top  = 0;
+    Vertex *from, *end;
+    
+    EM(from, (pts + 1) * sizeof(Vertex), e0);
+    EM(end,  (pts + 1) * sizeof(Vertex), e1);
+    
+    /* from[w] and end[w] of the first vertex w of a contracted chain are
+       the vertices the chain joins, label[w] of the rest of it is 0 */
+    
+    memset(from, 0, (pts + 1) * sizeof(Vertex));
+    memset(end,  0, (pts + 1) * sizeof(Vertex));
+    for (x = 1; x <= pts; x++) label[x] = x;
+    
+    for (x = 1; x <= pts; x++) {
+        if (d[x] == 2) continue;
+        for (a = h->adj_lists[x]; a; a = a->next) {
+            y = a->target;
+            if (d[y] != 2 || from[y]) continue;
+            
+            /* walk the chain, marking it as seen from its first vertex */
+            
+            p = x;
+            q = y;
+            c = 0;
+            while (d[q] == 2) {
+                from[q] = x;
+                r = nextForced(h, q, p);
+                p = q;
+                q = r;
+                if (c++ && label[p]) {
+                    label[p] = 0;
+                    k->stats.contracted++;
+                }
+            }
+            
+            /* a single degree 2 vertex stays as it is */
+            
+            if (c >= 2) end[y] = q;
+        }
+    }
+    
+    for (x = 1; x <= pts; x++) if (label[x]) label[x] = ++kpts;
+    
+    EM(k->orig,   (kpts + 1) * sizeof(Vertex), e2);
+    EM(k->from,   (kpts + 1) * sizeof(Vertex), e3);
+    EM(k->first,  (kpts + 1) * sizeof(UInt),   e4);
+    EM(k->length, (kpts + 1) * sizeof(UInt),   e5);
+    EM(k->chain,  (pts + 1) * sizeof(Vertex),  e6);
+    
+    g = initGraph(allocateGraph(h->name, kpts, st));
+    if (!g) goto e7;
+    
+    for (x = 1; x <= pts; x++) {
+        if (!(r = label[x])) continue;
+        
+        k->orig[r]      = x;
+        k->from[r]      = 0;
+        k->first[r]     = top;
+        k->length[r]    = 1;
+        k->chain[top++] = x;
+        
+        for (a = h->adj_lists[x]; a; a = a->next) {
+            y = a->target;
+            if (label[y] && y < x &&
+                (*st = createEdge(g, r, label[y])) != STATUS_OK) goto e8;
+        }
+        
+        if (!end[x]) continue;
+        
+        /* x stands for its chain, listed from the end it was entered */
+        
+        k->from[r] = label[from[x]];
+        
+        p = from[x];
+        q = x;
+        while ((y = nextForced(h, q, p)) != end[x]) {
+            k->chain[top++] = y;
+            k->length[r]++;
+            p = q;
+            q = y;
+        }
+        
+        if ((*st = createEdge(g, r, label[end[x]])) != STATUS_OK) goto e8;
+    }
+    
+    free(end);
+    free(from);
+    return g;
+    
+e8: releaseGraph(g);
+e7: free(k->chain);
+e6: free(k->length);
+e5: free(k->first);
+e4: free(k->from);
+e3: free(k->orig);
+e2: k->orig  = k->from = k->chain = NULL;
+    k->first = k->length = NULL;
+    free(end);
+e1: free(from);
+e0: if (*st == STATUS_OK) *st = STATUS_NO_MEM;
+    return NULL;
+    
+} /* contractChains */
+
+
+/*! Reduce a copy of g.  Returns HC_KERNEL_NO_CYCLE, with the reason in
+getKernelReason, when a rule shows g has no Hamilton cycle.  Otherwise
+getKernelGraph is a graph with as many Hamilton cycles as g, with no 
+vertex of degree < 2, no removable edge, no cut vertex and no two 
+adjacent degree 2 vertices unless it is a cycle. */
+
+HCKernelResult
+reduceGraph(HCKernelRef k, Graph *g, Status *status)
+{
+    Graph   *h;
+    Arc     *bridge;
+    bool    *seen;
+    Vertex  *label, cut;
+    bool     connected;
+    
+    UInt     pts = g->vertex_count;
+    
+    initKernel(k);
+    k->pts = pts;
+    
+    CHECK_RETURN_VAL(*status, HC_KERNEL_REDUCED);
+    
+    if (pts < 3) {
+        k->reason = "fewer than 3 vertices";
+        return HC_KERNEL_NO_CYCLE;
+    }
+    
+    if (!(h = copyGraph(g, status))) return HC_KERNEL_REDUCED;
+    
+    EM(seen,  (pts + 1) * sizeof(bool),   e0);
+    EM(label, (pts + 1) * sizeof(Vertex), e1);
+    
+    while (applyRules(k, h, seen));
+    
+    if (!k->reason) {
+        cut = findCutVertex(h, &bridge, &connected, status);
+        
+        if (!connected)    k->reason = "graph is not connected";
+        else if (bridge)   k->reason = "graph has a bridge";
+        else if (cut)      k->reason = "graph has a cut vertex";
+    }
+    
+    if (!k->reason && *status == STATUS_OK) 
+        k->graph = contractChains(k, h, label, status);
+    
+    free(label);
+    free(seen);
+    releaseGraph(h);
+    
+    return k->reason ? HC_KERNEL_NO_CYCLE : HC_KERNEL_REDUCED;
+    
+e1: free(seen);
+e0: releaseGraph(h);
+    *status = STATUS_NO_MEM;
+    return HC_KERNEL_REDUCED;
+    
+} /* reduceGraph */
+
+
+Graph *
+getKernelGraph(HCKernelRef k)
+{
+    return k->graph;
+} /* getKernelGraph */
+
+
+const char *
+getKernelReason(HCKernelRef k)
+{
+    return k->reason;
+} /* getKernelReason */
+
+
+void
+getKernelStatistics(HCKernelRef k, HCKernelStatistics *st)
+{
+    *st = k->stats;
+} /* getKernelStatistics */
+
+
+/*! Map a Hamilton cycle of the kernel graph back to the original graph,
+each contracted chain being put back in the direction it is traversed. */
+
+void
+expandKernelCycle(HCKernelRef k, Vertex *c, Vertex *v, Status *status)
+{
+    Vertex  *seq, *s, x, p, nx;
+    UInt     i, j;
+    
+    UInt     n  = k->graph->vertex_count;
+    UInt     pts = k->pts;
+    
+    CHECK_RETURN(*status);
+    
+    EM(seq, pts * sizeof(Vertex), e0);
+    
+    /* walk the kernel cycle, writing the original vertices in order */
+    
+    s = seq;
+    p = c[n + 1];
+    x = 1;
+    for (i = 0; i < n; i++) {
+        if (k->from[x] && k->from[x] != p) {
+            for (j = k->length[x]; j--; ) 
+                *s++ = k->chain[k->first[x] + j];
+        } else {
+            for (j = 0; j < k->length[x]; j++) 
+                *s++ = k->chain[k->first[x] + j];
+        }
+        
+        nx = c[x] != p ? c[x] : c[n + x];
+        p  = x;
+        x  = nx;
+    }
+    
+    /* store the neighbours of each vertex as getCurrentHamiltonianCycle 
+       does */
+    
+    for (i = 0; i < pts; i++) {
+        x  = seq[i];
+        nx = seq[(i + 1) % pts];
+        if (v[x]) v[pts + x] = nx; else v[x] = nx;
+        if (v[nx]) v[pts + nx] = x; else v[nx] = x;
+    }
+    
+    free(seq);
+    return;
+    
+e0: *status = STATUS_NO_MEM;
+    
+} /* expandKernelCycle */
@@ -0,0 +1,60 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef GRAPHREDUCTION_H
+#define GRAPHREDUCTION_H
+
+#include "Arch.h"
+#include "Graph.h"
+
+/*! Outcome of reduceGraph. */
+
+typedef enum hc_kernel_result {
+    HC_KERNEL_REDUCED   = 0,  /*!< kernel graph built, see getKernelGraph  */
+    HC_KERNEL_NO_CYCLE  = 1   /*!< graph shown to have no Hamilton cycle  */
+} HCKernelResult;
+
+typedef struct hc_kernel_statistics {
+    UInt  removedEdges;       /*!< edges in no Hamilton cycle            */
+    UInt  contracted;         /*!< degree 2 vertices merged into others  */
+    UInt  passes;             /*!< rounds of the reduction rules         */
+} HCKernelStatistics;
+
+typedef struct hc_kernel * HCKernelRef;  /* opaque type */
+
+HCKernelRef allocateKernel(Status *status);
+HCKernelRef initKernel(HCKernelRef k);
+void releaseKernel(HCKernelRef k);
+
+/* apply the reductions to a copy of g until none applies */
+HCKernelResult reduceGraph(HCKernelRef k, Graph *g, Status *status);
+
+Graph *getKernelGraph(HCKernelRef k);
+const char *getKernelReason(HCKernelRef k);
+void getKernelStatistics(HCKernelRef k, HCKernelStatistics *st);
+
+/* c is a cycle of the kernel graph in the form of 
+   getCurrentHamiltonianCycle, v (2n+1 entries initialized to 0's) 
+   receives the same cycle of the original graph, v is left unchanged
+   when out of memory */
+void expandKernelCycle(HCKernelRef k, Vertex *c, Vertex *v, 
+                       Status *status);
+
+#endif /* GRAPHREDUCTION_H */
@@ -0,0 +1,643 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "GraphSymmetry.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+
+/* NOTES:
+
+Every Hamilton cycle passes through the start vertex v0, and read from 
+v0 in both directions it gives two vertex sequences v0 v1 ... vn-1.  An 
+automorphism fixing v0 maps the cycles beginning with a path P to those
+beginning with its image, so with f(P) the number of cycles containing P
+
+    2 * cycles(G) = sum over the orbits O of paths P from v0 of |O| f(P).
+
+The orbits are built one vertex at a time: the extensions P+y of P fall
+into the orbits of y under the automorphisms fixing P vertex by vertex,
+and the orbit of P+y is |orbit of y| times the size of the orbit of P. 
+A prefix is extended while its extensions fall into fewer orbits than 
+there are extensions, then f(P) is counted by the tape engine on a copy
+of G where P is forced: its inner vertices keep only their path edges, 
+a single edge is subdivided.  For a vertex transitive graph the search 
+shrinks by up to the order of the group over n, the order of the 
+stabilizer of v0.
+
+Whether an automorphism fixing P maps x to y is decided by refining the
+colourings of two copies of G, P individualized in both and x in the
+first, y in the second, by the multisets of neighbour colours.  When the
+classes differ in size there is none, when they are single vertices the
+map is checked, otherwise a vertex of the smallest class of the first 
+copy is matched in turn with each of its class in the second. */
+
+struct hc_symmetry {
+    bool        prune;      /* search prefixes with pruning */
+    double      deadline;   /* monotonic time limit, 0 for none */
+    HCSymmetryStatistics stats;
+    
+    /* work arrays of the graph being searched */
+    
+    Graph      *g;
+    UInt        pts;
+    struct refine_key *keys;
+    UInt       *count;      /* class sizes of the two copies */
+    Vertex     *pos;        /* position + 1 of each vertex in the prefix */
+};
+
+typedef struct refine_key {
+    ULongLong   key;
+    UInt        at;         /* vertex, plus n in the second copy */
+} RefineKey;
+
+
+HCSymmetryRef
+allocateSymmetry(Status *status)
+{
+    HCSymmetryRef sy;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    EM(sy, sizeof(struct hc_symmetry), e0);
+    
+    sy->g     = NULL;
+    sy->keys  = NULL;
+    sy->count = NULL;
+    sy->pos   = NULL;
+    
+    return initSymmetry(sy, false, 0);
+    
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocateSymmetry */
+
+
+HCSymmetryRef
+initSymmetry(HCSymmetryRef sy, bool prune, double seconds)
+{
+    if (!sy) return NULL;
+    
+    sy->prune    = prune;
+    sy->deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    memset(&sy->stats, 0, sizeof(HCSymmetryStatistics));
+    
+    return sy;
+    
+} /* initSymmetry */
+
+
+void
+releaseSymmetry(HCSymmetryRef sy)
+{
+    free(sy);
+} /* releaseSymmetry */
+
+
+static void
+releaseWork(HCSymmetryRef sy)
+{
+    free(sy->pos);
+    free(sy->count);
+    free(sy->keys);
+    
+    sy->g     = NULL;
+    sy->keys  = NULL;
+    sy->count = NULL;
+    sy->pos   = NULL;
+    
+} /* releaseWork */
+
+
+static bool
+allocateWork(HCSymmetryRef sy, Graph *g, Status *st)
+{
+    UInt    n = g->vertex_count;
+    
+    CHECK_RETURN_VAL(*st, false);
+    
+    sy->g   = g;
+    sy->pts = n;
+    
+    EM(sy->keys,  2 * n * sizeof(RefineKey),   e0);
+    EM(sy->count, 2 * (2 * n + 1) * sizeof(UInt), e1);
+    EM(sy->pos,   (n + 1) * sizeof(Vertex),    e2);
+    
+    memset(sy->pos, 0, (n + 1) * sizeof(Vertex));
+    
+    return true;
+    
+e2: free(sy->count);
+e1: free(sy->keys);
+e0: sy->keys  = NULL;
+    sy->count = NULL;
+    sy->g     = NULL;
+    *st = STATUS_NO_MEM;
+    return false;
+    
+} /* allocateWork */
+
+
+static inline ULongLong
+mix(ULongLong z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+} /* mix */
+
+
+static int
+compareKeys(const void *a, const void *b)
+{
+    const RefineKey *p = a;
+    const RefineKey *q = b;
+    
+    if (p->key != q->key) return p->key < q->key ? -1 : 1;
+    return p->at < q->at ? -1 : p->at > q->at;
+    
+} /* compareKeys */
+
+
+/*! Refine the colourings c1 and c2 (1..*classes) of the two copies 
+together until the classes no longer split.  False when a class has 
+different sizes in the two copies, so no map between them exists. */
+
+static bool
+refine(HCSymmetryRef sy, Vertex *c1, Vertex *c2, UInt *classes)
+{
+    Arc        *a;
+    Vertex     *c, x;
+    ULongLong   sum;
+    UInt        i, r, side;
+    
+    UInt        n     = sy->pts;
+    RefineKey  *k     = sy->keys;
+    UInt       *cnt   = sy->count;
+    Arc       **L     = sy->g->adj_lists;
+    
+    for (;;) {
+        for (side = 0; side < 2; side++) {
+            c = side ? c2 : c1;
+            for (x = 1; x <= n; x++) {
+                sum = 0;
+                for (a = L[x]; a; a = a->next) sum += mix(c[a->target]);
+                k->key  = mix(sum ^ mix((ULongLong)c[x] << 32));
+                k->at   = x + side * n;
+                k++;
+            }
+        }
+        k = sy->keys;
+        qsort(k, 2 * n, sizeof(RefineKey), compareKeys);
+        
+        /* the new colour of a vertex is the rank of its key */
+        
+        memset(cnt, 0, 2 * (2 * n + 1) * sizeof(UInt));
+        for (r = 0, i = 0; i < 2 * n; i++) {
+            if (!i || k[i].key != k[i - 1].key) r++;
+            if (k[i].at > n) {
+                c2[k[i].at - n] = r;
+                cnt[2 * r + 1]++;
+            } else {
+                c1[k[i].at] = r;
+                cnt[2 * r]++;
+            }
+        }
+        
+        for (i = 1; i <= r; i++) if (cnt[2 * i] != cnt[2 * i + 1]) 
+            return false;
+        
+        if (r <= *classes) return true;
+        *classes = r;
+    }
+    
+} /* refine */
+
+
+/*! Search for a map from the first copy to the second that keeps the 
+colours and the edges, individualizing vertices of the smallest class 
+until every class is a single vertex. */
+
+static bool
+matchColourings(HCSymmetryRef sy, Vertex *c1, Vertex *c2, UInt classes, 
+                Vertex *map, Status *st)
+{
+    Arc     *e;
+    Vertex  *n1, *n2, x, y, a, best;
+    UInt     size;
+    
+    UInt     n     = sy->pts;
+    UInt    *cnt   = sy->count;
+    bool   **M     = sy->g->adj_matrix;
+    bool     found = false;
+    
+    if (!refine(sy, c1, c2, &classes)) return false;
+    
+    if (classes == n) {
+        
+        /* discrete, check the only map the colours allow */
+        
+        for (y = 1; y <= n; y++) map[c2[y]] = y;
+        for (x = 1; x <= n; x++) c1[x] = map[c1[x]];
+        for (x = 1; x <= n; x++) {
+            for (e = sy->g->adj_lists[x]; e; e = e->next) 
+                if (!M[c1[x]][c1[e->target]]) return false;
+        }
+        memcpy(map, c1, (n + 1) * sizeof(Vertex));
+        return true;
+    }
+    
+    /* the first vertex of the smallest class is matched in turn */
+    
+    memset(cnt, 0, (classes + 1) * sizeof(UInt));
+    for (x = 1; x <= n; x++) cnt[c1[x]]++;
+    
+    best = 0;
+    size = n + 1;
+    for (x = 1; x <= n; x++) {
+        if (cnt[c1[x]] > 1 && cnt[c1[x]] < size) {
+            size = cnt[c1[x]];
+            best = x;
+        }
+    }
+    
+    EM(n1, (n + 1) * sizeof(Vertex), e0);
+    EM(n2, (n + 1) * sizeof(Vertex), e1);
+    
+    a = best;
+    for (y = 1; y <= n && !found && *st == STATUS_OK; y++) {
+        if (c2[y] != c1[a]) continue;
+        
+        memcpy(n1, c1, (n + 1) * sizeof(Vertex));
+        memcpy(n2, c2, (n + 1) * sizeof(Vertex));
+        n1[a] = n2[y] = classes + 1;
+        
+        found = matchColourings(sy, n1, n2, classes + 1, map, st);
+    }
+    
+    free(n2);
+    free(n1);
+    return found;
+    
+e1: free(n1);
+e0: *st = STATUS_NO_MEM;
+    return false;
+    
+} /* matchColourings */
+
+
+/*! findAutomorphism on the graph of the work arrays. */
+
+static bool
+testAutomorphism(HCSymmetryRef sy, Vertex *fix, UInt nfix, Vertex x, 
+                 Vertex y, Vertex *map, Status *st)
+{
+    Vertex  *c1, *c2, *m, v;
+    UInt     i;
+    bool     found;
+    
+    UInt     n = sy->pts;
+    
+    CHECK_RETURN_VAL(*st, false);
+    
+    if (sy->g->degree[x] != sy->g->degree[y]) return false;
+    
+    sy->stats.tests++;
+    
+    EM(c1, (n + 1) * sizeof(Vertex), e0);
+    EM(c2, (n + 1) * sizeof(Vertex), e1);
+    EM(m,  (n + 1) * sizeof(Vertex), e2);
+    
+    /* the fixed vertices, x and y get colours of their own */
+    
+    for (v = 1; v <= n; v++) c1[v] = c2[v] = nfix + 2;
+    for (i = 0; i < nfix; i++) c1[fix[i]] = c2[fix[i]] = i + 1;
+    c1[x] = c2[y] = nfix + 1;
+    
+    found = matchColourings(sy, c1, c2, 0, m, st);
+    if (found && map) memcpy(map, m, (n + 1) * sizeof(Vertex));
+    
+    free(m);
+    free(c2);
+    free(c1);
+    return found;
+    
+e2: free(c2);
+e1: free(c1);
+e0: *st = STATUS_NO_MEM;
+    return false;
+    
+} /* testAutomorphism */
+
+
+bool
+findAutomorphism(HCSymmetryRef sy, Graph *g, Vertex *fix, UInt nfix,
+                 Vertex x, Vertex y, Vertex *map, Status *status)
+{
+    bool    found;
+    
+    if (!allocateWork(sy, g, status)) return false;
+    
+    found = testAutomorphism(sy, fix, nfix, x, y, map, status);
+    
+    releaseWork(sy);
+    return found;
+    
+} /* findAutomorphism */
+
+
+/*! The start vertex: the first vertex of highest degree in the smallest 
+class of the refined colouring, which depends on the graph only up to 
+isomorphism. */
+
+static Vertex
+startVertex(HCSymmetryRef sy, Status *st)
+{
+    Vertex  *c, x, best;
+    UInt     classes = 0;
+    
+    UInt     n    = sy->pts;
+    UInt    *cnt  = sy->count;
+    UInt    *d    = sy->g->degree;
+    
+    EM(c, (n + 1) * sizeof(Vertex), e0);
+    
+    for (x = 1; x <= n; x++) c[x] = 1;
+    refine(sy, c, c, &classes);
+    
+    memset(cnt, 0, (classes + 1) * sizeof(UInt));
+    for (x = 1; x <= n; x++) cnt[c[x]]++;
+    
+    for (best = 1, x = 2; x <= n; x++) {
+        if (cnt[c[x]] < cnt[c[best]] || 
+            (cnt[c[x]] == cnt[c[best]] && d[x] > d[best])) best = x;
+    }
+    
+    free(c);
+    return best;
+    
+e0: *st = STATUS_NO_MEM;
+    return 0;
+    
+} /* startVertex */
+
+
+/*! Count, or decide, the Hamilton cycles through the path of k vertices
+of the prefix p, on a copy of the graph forcing it. */
+
+static HCSearchStatus
+searchPrefix(HCSymmetryRef sy, Vertex *p, UInt k, bool decide, 
+             ULongLong *c, Status *st)
+{
+    Graph          *h;
+    Arc            *a;
+    HCStateRef      hc;
+    VArray         *vo;
+    HCSearchStatus  result;
+    Vertex          x, y;
+    bool            found, inner;
+    double          seconds = 0;
+    
+    Graph          *g   = sy->g;
+    UInt            n   = sy->pts;
+    Vertex         *pos = sy->pos;
+    
+    *c = 0;
+    
+    if (sy->deadline) {
+        seconds = sy->deadline - monotonicSeconds();
+        if (seconds <= 0) return HC_SEARCH_UNDECIDED;
+    }
+    
+    if (!(h = initGraph(allocateGraph(g->name, n + (k == 2), st)))) 
+        return HC_SEARCH_UNDECIDED;
+    
+    /* inner path vertices keep their path edges, the single edge of a 
+       2 vertex prefix is forced through a new vertex */
+    
+    for (x = 1; x <= n; x++) {
+        for (a = g->adj_lists[x]; a; a = a->next) {
+            y = a->target;
+            if (y < x) continue;
+            
+            inner = (pos[x] > 1 && pos[x] < k) || (pos[y] > 1 && pos[y] < k);
+            if (pos[x] && pos[y] && 
+                (pos[x] == pos[y] + 1 || pos[y] == pos[x] + 1)) {
+                if (k == 2) continue;
+            } else if (inner) continue;
+            
+            if ((*st = createEdge(h, x, y)) != STATUS_OK) goto e0;
+        }
+    }
+    if (k == 2) {
+        if ((*st = createEdge(h, n + 1, p[0])) != STATUS_OK) goto e0;
+        if ((*st = createEdge(h, n + 1, p[1])) != STATUS_OK) goto e0;
+    }
+    
+    sy->stats.prefixes++;
+    
+    vo = sortVerticesDegreeDesc(
+            initVArray(allocateVArray(h->vertex_count, st)), h->degree);
+    hc = allocateHCState(h->vertex_count, st);
+    if (*st != STATUS_OK) {
+        if (vo) releaseVArray(vo);
+        if (hc) releaseHCState(hc);
+        goto e0;
+    }
+    
+    initHCState(hc, h->degree, h->adj_lists, vo);
+    setHCSearchLimits(hc, 0, seconds);
+    
+    found = sy->prune ? firstHamiltonianCycleWithPruning(hc)
+                      : firstHamiltonianCycle(hc);
+    if (found) (*c)++;
+    
+    if (!decide && found) {
+        while (sy->prune ? nextHamiltonianCycleWithPruning(hc)
+                         : nextHamiltonianCycle(hc)) (*c)++;
+    }
+    
+    result = getHCSearchStatus(hc);
+    if (result != HC_SEARCH_UNDECIDED) 
+        result = *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+    releaseHCState(hc);
+    releaseVArray(vo);
+    releaseGraph(h);
+    
+    return result;
+    
+e0: releaseGraph(h);
+    return HC_SEARCH_UNDECIDED;
+    
+} /* searchPrefix */
+
+
+/*! Add to *total the prefix p of k vertices times weight, the size of its
+orbit, counted in both directions: searched when its extensions are in 
+orbits of their own, otherwise extended by a representative of each. */
+
+static HCSearchStatus
+extendPrefix(HCSymmetryRef sy, Vertex *p, UInt k, ULongLong weight, 
+             bool decide, ULongLong *total, Status *st)
+{
+    Arc            *a;
+    Vertex         *cand, *rep, y;
+    ULongLong       c;
+    UInt            m, i, j, orbits, size;
+    HCSearchStatus  result = HC_SEARCH_EXHAUSTED;
+    
+    Vertex         *pos = sy->pos;
+    Vertex          x   = p[k - 1];
+    
+    EM(cand, (sy->g->degree[x] + 1) * sizeof(Vertex), e0);
+    EM(rep,  (sy->g->degree[x] + 1) * sizeof(Vertex), e1);
+    
+    for (m = 0, a = sy->g->adj_lists[x]; a; a = a->next) 
+        if (!pos[a->target]) cand[m++] = a->target;
+    
+    /* rep[i] is the first candidate known to be in the orbit of i */
+    
+    for (orbits = 0, i = 0; i < m && *st == STATUS_OK; i++) {
+        rep[i] = i;
+        for (j = 0; j < i; j++) {
+            if (rep[j] == j && 
+                testAutomorphism(sy, p, k, cand[j], cand[i], NULL, st)) {
+                rep[i] = j;
+                break;
+            }
+        }
+        if (rep[i] == i) orbits++;
+    }
+    
+    if (*st != STATUS_OK) {
+        result = HC_SEARCH_UNDECIDED;
+    } else if (orbits == m) {
+        
+        /* no symmetry left to use */
+        
+        result = searchPrefix(sy, p, k, decide, &c, st);
+        
+        /* from the start vertex alone each cycle is read twice */
+        
+        if (k == 1) c *= 2;
+        *total += weight * c;
+        sy->stats.covered += weight;
+    } else {
+        for (i = 0; i < m; i++) {
+            if (rep[i] != i) continue;
+            
+            for (size = 0, j = i; j < m; j++) if (rep[j] == i) size++;
+            
+            y      = cand[i];
+            p[k]   = y;
+            pos[y] = k + 1;
+            
+            result = extendPrefix(sy, p, k + 1, weight * size, decide, 
+                                  total, st);
+            pos[y] = 0;
+            
+            if (result == HC_SEARCH_UNDECIDED || (decide && *total)) break;
+        }
+    }
+    
+    free(rep);
+    free(cand);
+    
+    if (result == HC_SEARCH_UNDECIDED) return result;
+    return *total ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e1: free(cand);
+e0: *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* extendPrefix */
+
+
+static HCSearchStatus
+searchSymmetric(HCSymmetryRef sy, Graph *g, bool decide, ULongLong *cycles,
+                Status *st)
+{
+    Vertex         *p;
+    ULongLong       total = 0;
+    HCSearchStatus  result;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*st, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count < 3) return HC_SEARCH_EXHAUSTED;
+    
+    if (!allocateWork(sy, g, st)) return HC_SEARCH_UNDECIDED;
+    
+    EM(p, (g->vertex_count + 1) * sizeof(Vertex), e0);
+    
+    if (!(p[0] = startVertex(sy, st))) {
+        free(p);
+        releaseWork(sy);
+        return HC_SEARCH_UNDECIDED;
+    }
+    
+    sy->stats.start = p[0];
+    sy->pos[p[0]]   = 1;
+    
+    result  = extendPrefix(sy, p, 1, 1, decide, &total, st);
+    *cycles = decide ? total > 0 : total / 2;
+    
+    free(p);
+    releaseWork(sy);
+    return result;
+    
+e0: releaseWork(sy);
+    *st = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* searchSymmetric */
+
+
+HCSearchStatus
+countBySymmetry(HCSymmetryRef sy, Graph *g, ULongLong *cycles, 
+                Status *status)
+{
+    return searchSymmetric(sy, g, false, cycles, status);
+} /* countBySymmetry */
+
+
+HCSearchStatus
+decideBySymmetry(HCSymmetryRef sy, Graph *g, Status *status)
+{
+    ULongLong c;
+    
+    return searchSymmetric(sy, g, true, &c, status);
+} /* decideBySymmetry */
+
+
+void
+getSymmetryStatistics(HCSymmetryRef sy, HCSymmetryStatistics *st)
+{
+    *st = sy->stats;
+} /* getSymmetryStatistics */
@@ -0,0 +1,64 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef GRAPHSYMMETRY_H
+#define GRAPHSYMMETRY_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/*! Work done by a symmetric search, see getSymmetryStatistics. */
+
+typedef struct hc_symmetry_statistics {
+    Vertex     start;      /*!< vertex every prefix starts at            */
+    UInt       tests;      /*!< automorphism searches run                */
+    UInt       prefixes;   /*!< orbit representatives searched           */
+    ULongLong  covered;    /*!< prefixes those representatives stand for */
+} HCSymmetryStatistics;
+
+typedef struct hc_symmetry * HCSymmetryRef;  /* opaque type */
+
+HCSymmetryRef allocateSymmetry(Status *status);
+
+/* prefixes are searched with pruning when prune is set, a search stops 
+   after seconds (0 for no limit) */
+HCSymmetryRef initSymmetry(HCSymmetryRef sy, bool prune, double seconds);
+void releaseSymmetry(HCSymmetryRef sy);
+
+/* true when an automorphism of g fixes each of the nfix vertices of fix 
+   and maps x to y, it is stored in map (n+1 entries) when map != NULL */
+bool findAutomorphism(HCSymmetryRef sy, Graph *g, Vertex *fix, 
+                      UInt nfix, Vertex x, Vertex y, Vertex *map, 
+                      Status *status);
+
+/* count the Hamilton cycles of g, or decide if there is one, searching 
+   one path from the start vertex of each orbit of the automorphisms 
+   fixing it.  HC_SEARCH_UNDECIDED is returned when the time limit is 
+   reached. */
+HCSearchStatus countBySymmetry(HCSymmetryRef sy, Graph *g, 
+                               ULongLong *cycles, Status *status);
+HCSearchStatus decideBySymmetry(HCSymmetryRef sy, Graph *g, 
+                                Status *status);
+
+void getSymmetryStatistics(HCSymmetryRef sy, HCSymmetryStatistics *st);
+
+#endif /* GRAPHSYMMETRY_H */
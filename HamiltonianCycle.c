@@ -24,10 +24,16 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <stddef.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include <math.h>
 
 #include "Arch.h"
 #include "Graph.h"
 #include "DFSAlgorithms.h"
+#include "VertexOrder.h"
+#include "Random.h"
+#include "Timer.h"
+#include "MemoTable.h"
 #include "HamiltonianCycle.h"
 
 /* NOTES ON TERMS USED IN COMMENTS:  
@@ -49,6 +55,8 @@ degree 3. */
 typedef struct hc_flags {
     bool isHamiltonian;
     bool isHamiltonCycle;
+    bool isPrimed;          /* a first call has been made since init */
+    bool tracksProgress;    /* branch counts kept for getHCProgress */
 } HCFlags;
 
 
@@ -86,19 +94,251 @@ struct hc_state {
     Arc       *removedEdges;
     Arc      **removedEdgesStack;
     Vertex     *deg2Stack;
+    Vertex     *label;         /* original labels of a relabeled graph */
+    Vertex     *required;      /* edges every cycle must use, x,y pairs */
+    UInt        requiredCount;
+    Vertex     *forbidden;     /* edges no cycle may use, x,y pairs */
+    UInt        forbiddenCount;
+    HCSearchStatus status;     /* outcome of the last search call */
+    atomic_bool cancelled;     /* set by cancelHamiltonianCycleSearch */
+    ULongLong   rotations;     /* anchor rotations made by this state */
+    ULongLong   rotationLimit; /* stop when rotations reaches this */
+    ULongLong   checkpoint;    /* rotation count of next limit check */
+    ULongLong   clockCheck;    /* rotation count of next clock reading */
+    double      deadline;      /* monotonic time to stop at, 0 if none */
+    HCStatistics stats;        /* counters, see HC_STATISTICS */
+    UInt       *branch;        /* rotations made at each tape position */
+    UInt       *branchTop;     /* highest nonzero entry of branch */
+    HCTape     *lowest;        /* lowest anchor rotated since last reset */
+    ULongLong   cycles;        /* cycles found since the last first call */
+#ifdef HC_TRACE
+    HCTraceEvent *trace;       /* ring of the last HC_TRACE_EVENTS events */
+    atomic_ullong traceHead;   /* events recorded since initHCState */
+    double      traceStart;    /* monotonic time of initHCState */
+#endif
 };
 
+/* number of anchor rotations between reads of the clock when a search
+   has a deadline */
+
+#define HC_CLOCK_INTERVAL 1024
+
+/* hot path counters, compiled in only when HC_STATISTICS is defined so 
+   that a normal build pays nothing for them */
+
+#ifdef HC_STATISTICS
+#define HC_STAT_INC(s, counter)  ((s)->stats.counter++)
+#define HC_STAT_DEPTH(s)                                                \
+    do {                                                                \
+        UInt depth_ = (UInt)((s)->pos - (s)->origin);                   \
+        if (depth_ > (s)->stats.maxDepth) (s)->stats.maxDepth = depth_; \
+    } while (0)
+#else
+#define HC_STAT_INC(s, counter)  ((void)0)
+#define HC_STAT_DEPTH(s)         ((void)0)
+#endif
+
+/* tape event tracing, compiled in only when HC_TRACE is defined.  The 
+   searching thread is the only writer of the ring, it publishes each 
+   event by advancing traceHead so readers never take a lock. */
+
+#ifdef HC_TRACE
+#ifndef HC_TRACE_EVENTS
+#define HC_TRACE_EVENTS  65536      /* a power of 2 */
+#endif
+#define HC_TRACE_EVENT(s, kind, x, hx)  traceEvent((s), (kind), (x), (hx))
+
+static inline void
+traceEvent(HCStateRef s, HCTraceType kind, Vertex x, HCTape *hx)
+{
+    ULongLong     n  = atomic_load_explicit(&s->traceHead, 
+                                            memory_order_relaxed);
+    HCTraceEvent *ev = s->trace + (n & (HC_TRACE_EVENTS - 1));
+    
+    ev->time   = monotonicSeconds() - s->traceStart;
+    ev->type   = kind;
+    ev->depth  = (UInt)(hx - s->origin);
+    ev->vertex = x;
+    
+    atomic_store_explicit(&s->traceHead, n + 1, memory_order_release);
+}
+#else
+#define HC_TRACE_EVENT(s, kind, x, hx)  ((void)0)
+#endif
+
+/* residual graph keys, see residualKey.  The tape primitives given an 
+   HCKey fold every change of an arc list, a virtual edge or the vertices
+   on the graph into its key and check, and into the terms kept for every
+   vertex whether on the graph or not, so that a key costs nothing to read
+   at an anchor.  Every other search passes NULL, which leaves the 
+   primitives as they were once inlined into it. */
+
+typedef struct hc_key {
+    ULongLong  *zobrist;       /* random values of each vertex, two each */
+    ULongLong  *vertexKey;     /* key terms of each vertex, two each */
+    UInt       *degree;        /* of the state, 0 when off the graph */
+    bool       *keyed;         /* vertices whose terms are in key */
+    ULongLong   key;
+    ULongLong   check;
+} HCKey;
+
+static inline ULongLong
+mixKey(ULongLong z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+
+/*! Add or remove the arc from x to y in the list of x. */
+
+static void
+keyArc(HCKey *rk, Vertex x, Vertex y)
+{
+    ULongLong  k, c;
+    
+    ULongLong *z = rk->zobrist;
+    ULongLong *v = rk->vertexKey + 2 * x;
+    
+    if (y < x) return;
+    
+    k     = mixKey(z[2 * x] + 3 * z[2 * y]);
+    c     = mixKey(z[2 * x + 1] + 3 * z[2 * y + 1]);
+    v[0] ^= k;
+    v[1] ^= c;
+    
+    if (rk->keyed[x]) {
+        rk->key   ^= k;
+        rk->check ^= c;
+    }
+} /* keyArc */
+
+
+/*! The virtual edge of x changes from y to w (0 for none). */
+
+static void
+keyVirtual(HCKey *rk, Vertex x, Vertex y, Vertex w)
+{
+    ULongLong  k = 0, c = 0;
+    
+    ULongLong *z = rk->zobrist;
+    ULongLong *v = rk->vertexKey + 2 * x;
+    
+    if (!x) return;
+    
+    if (y > x) {
+        k ^= mixKey(z[2 * x] + 3 * z[2 * y] + 1);
+        c ^= mixKey(z[2 * x + 1] + 3 * z[2 * y + 1] + 1);
+    }
+    if (w > x) {
+        k ^= mixKey(z[2 * x] + 3 * z[2 * w] + 1);
+        c ^= mixKey(z[2 * x + 1] + 3 * z[2 * w + 1] + 1);
+    }
+    v[0] ^= k;
+    v[1] ^= c;
+    
+    if (rk->keyed[x]) {
+        rk->key   ^= k;
+        rk->check ^= c;
+    }
+} /* keyVirtual */
+
+
+/*! Take the terms of x into the key or out of it as x is on the graph
+or not, nothing when they already agree. */
+
+static inline void
+syncVertex(HCKey *rk, Vertex x)
+{
+    if (!rk->degree[x] == !rk->keyed[x]) return;
+    
+    rk->keyed[x] = !rk->keyed[x];
+    rk->key     ^= rk->vertexKey[2 * x];
+    rk->check   ^= rk->vertexKey[2 * x + 1];
+} /* syncVertex */
+
+
+/*! Add or remove both arcs of the edge from x to y. */
+
+static void
+keyEdge(HCKey *rk, Vertex x, Vertex y)
+{
+    keyArc(rk, x, y);
+    keyArc(rk, y, x);
+} /* keyEdge */
+
+
+/*! Add or remove the incoming arcs of the source of a, all but a->cross,
+as removeInArcs and restoreInArcsWithCount do. */
+
+static void
+keyInArcs(HCKey *rk, Arc *a)
+{
+    Arc   *p;
+    
+    for (p = a->prev; p != a; p = p->prev) 
+        keyArc(rk, p->target, p->cross->target);
+} /* keyInArcs */
+
+
+/*! Add or remove the edges on the list a, linked by next. */
+
+static void
+keyEdges(HCKey *rk, Arc *a)
+{
+    for ( ; a; a = a->next) keyEdge(rk, a->target, a->cross->target);
+} /* keyEdges */
+
+
+/*! The vertices extendSegments took off the graph or put back, the one 
+its caller took off included, are the sources of the arcs it wrote to 
+the tape after h and the forced vertices of those.  Sync them once it
+returns rather than at every step. */
+
+static void
+keyExtension(HCKey *rk, HCTape *h, HCTape *hx)
+{
+    for (h++; h <= hx; h++) {
+        syncVertex(rk, h->arc->target);
+        if (h->status & HC_FORCED) syncVertex(rk, h->arc->cross->target);
+    }
+} /* keyExtension */
+
+
+/*! Set the degree of x to k, 0 taking x off the graph.  A degree that 
+only moves by one never reaches or leaves 0 and is changed in place. */
+
+static inline void
+setDegree(HCKey *rk, UInt *d, Vertex x, UInt k)
+{
+    d[x] = k;
+    if (rk) syncVertex(rk, x);
+} /* setDegree */
+
+
+/*! Set the virtual edge of x to w. */
+
+static inline void
+setVirtualEdge(HCKey *rk, Vertex *e, Vertex x, Vertex w)
+{
+    if (rk && e[x] != w) keyVirtual(rk, x, e[x], w);
+    e[x] = w;
+} /* setVirtualEdge */
+
+
 /*! Removes the bit flags that indicate an endpoint of a segment.
 Will restore the incoming arc 'a' back to the graph if nesseary.
 Called only from extendSegments. */
 
 static inline void
-fixInArc(Arc **L, Arc *a, Vertex x, UInt *kPtr)
+fixInArc(HCKey *rk, Arc **L, Arc *a, Vertex x, UInt *kPtr)
 {
     UInt k = *kPtr;
 
     if (k & (HC_ENDPOINT)) {
         insertArc(L + x, a);
+        if (rk) keyArc(rk, x, a->target);
         k &= ~HC_ENDPOINT;
         *kPtr = k;
     }
@@ -110,7 +350,8 @@ is function is only called by extendSegments and is declared only
 to allow more clarity in extendSegments for arc status attributes. */
 
 static inline bool
-removeForcedD2InArcs(Arc **L, Arc *a, UInt *d, Vertex **d2Ptr)
+removeForcedD2InArcs(HCKey *rk, Arc **L, Arc *a, UInt *d, 
+                     Vertex **d2Ptr)
 {
     Vertex  y;
     UInt    dy;
@@ -148,6 +389,7 @@ removeForcedD2InArcs(Arc **L, Arc *a, UInt *d, Vertex **d2Ptr)
         return true;
     }
     
+    if (rk) keyInArcs(rk, a);
     *d2Ptr = d2;
     return false;
 } /* removeForcedD2InArcs */
@@ -180,7 +422,7 @@ endpoint while trying to extend.
 */
 
 static inline bool
-extendSegments(HCStateRef s, Arc *a, Vertex z, UInt k, Vertex *d2)
+extendSegments(HCStateRef s, HCKey *rk, Arc *a, Vertex z, UInt k, Vertex *d2)
 {
     Vertex       ex, x;
     Arc        *c;                /* cross arc directed at current endpoint */
@@ -191,6 +433,10 @@ extendSegments(HCStateRef s, Arc *a, Vertex z, UInt k, Vertex *d2)
     
     HCTape  *hz = NULL;            /* tape position for other endpoint */
     HCTape  *hx = s->pos;    /* tape position for current endpoint */
+    HCTape  *h0 = s->pos;    /* tape position before the extension */
+
+    HC_STAT_INC(s, extensions);
+    HC_TRACE_EVENT(s, HC_TRACE_EXTEND, a->cross->target, hx);
 
 extend_segment:
 
@@ -210,13 +456,14 @@ extend_segment:
     
         /* a cycle is forced */
 
-        if (hz) fixInArc(L, hz->arc, z, &hz->status);
+        if (hz) fixInArc(rk, L, hz->arc, z, &hz->status);
 
         /* restore focal point, no longer nessary to maintain tape position 
            at this point */
 
         d[c->target] = 2;         
         s->pos       = hx - 1;
+        if (rk) keyExtension(rk, h0, hx);
         
         /* determine if cycle is a Hamilton cycle */
         
@@ -234,21 +481,25 @@ extend_segment:
            to extend the segment. */
            
         if (d[x] > 2) { 
-            if (removeForcedD2InArcs(L, c, d, &d2)){
+            if (removeForcedD2InArcs(rk, L, c, d, &d2)){
                 
                 /* ensure that segment endpoint info removed and
                    that source of arc a is placed back on graph */
                    
-                if (hz) fixInArc(L, hz->arc, z, &hz->status);
+                if (hz) fixInArc(rk, L, hz->arc, z, &hz->status);
                 hx->status = k;
                 s->pos     = hx;
+                if (rk) keyExtension(rk, h0, hx);
                 return false;
             }
             
             k |= HC_FORCED_DEG2;
+            HC_STAT_INC(s, forcedDeg2);
+            HC_TRACE_EVENT(s, HC_TRACE_FORCED, x, hx);
         }
 
         hx->status = k | HC_FORCED;
+        HC_STAT_INC(s, forced);
         d[x]       = 0;
         
         
@@ -285,7 +536,7 @@ extend_segment:
             a    = L[z]->prev;
             d[z] = 0;
             
-            if (hz) fixInArc(L, hz->arc, z, &hz->status);
+            if (hz) fixInArc(rk, L, hz->arc, z, &hz->status);
 
             z    = ex;
             hz   = hx;
@@ -320,12 +571,13 @@ extend_segment:
        
     hx->status = k | HC_ENDPOINT;
     removeArc(L + x, c);
+    if (rk) keyArc(rk, x, c->target);
     
     if (d[z] != 2) goto finish_segment;
 
     a = L[z]->prev;
 
-    if (hz) fixInArc(L, hz->arc, z, &hz->status);
+    if (hz) fixInArc(rk, L, hz->arc, z, &hz->status);
 
     d[z] = 0;
     
@@ -354,6 +606,7 @@ finish_segment:
         c = a->cross;
         removeArc(L + a->target, c);
         removeArc(L + c->target, a);
+        if (rk) keyEdge(rk, x, z);
         a->next = s->removedEdges;
         s->removedEdges = a;
         
@@ -363,14 +616,14 @@ finish_segment:
             d[x] = 0;
             
             a = L[x]->prev;
-            fixInArc(L, hx->arc, x, &hx->status);
+            fixInArc(rk, L, hx->arc, x, &hx->status);
             k = 0;
             goto extend_segment;
         }
         
         if (--d[z] == 2) {
             a    = L[z]->prev;
-            if (hz) fixInArc(L, hz->arc, z, &hz->status);
+            if (hz) fixInArc(rk, L, hz->arc, z, &hz->status);
             d[z] = 0;
             
             hz   = hx;
@@ -384,8 +637,8 @@ finish_segment:
     /* a new virtual edge has been created that is consistant within
        its local area of the graph (its endpoints) */
     
-    e[z] = x;
-    e[x] = z;
+    setVirtualEdge(rk, e, z, x);
+    setVirtualEdge(rk, e, x, z);
     
     /* check if any more segments need to be grown */
     
@@ -408,6 +661,7 @@ finish_segment:
     }
 
     s->pos = hx;
+    if (rk) keyExtension(rk, h0, hx);
     return true;
 
 } /* extendSegments */
@@ -415,13 +669,15 @@ finish_segment:
 
 
 static inline UInt
-restoreInArcsWithCount(Arc **L, Arc *a, UInt *d) {
+restoreInArcsWithCount(HCKey *rk, Arc **L, Arc *a, UInt *d) {
 
     Vertex  v;
     
     UInt    c = 0;
     Arc   *p = a->prev;
     
+    if (rk) keyInArcs(rk, a);
+    
     while (p != a) {
         v = p->target;
         insertArc(L + v, p->cross);
@@ -436,11 +692,13 @@ restoreInArcsWithCount(Arc **L, Arc *a, UInt *d) {
 
 
 static inline void
-restoreEdges(Arc **L, Arc *a, UInt *d)
+restoreEdges(HCKey *rk, Arc **L, Arc *a, UInt *d)
 {
     Vertex  u, v;
     Arc   *n;
 
+    if (rk) keyEdges(rk, a);
+    
     while (a) {
         n = a->next;
         u = a->target;
@@ -456,7 +714,7 @@ restoreEdges(Arc **L, Arc *a, UInt *d)
 
 
 static inline void
-unrollArc(Arc **L, Vertex *e, UInt *d, Arc *a, UInt k)
+unrollArc(HCKey *rk, Arc **L, Vertex *e, UInt *d, Arc *a, UInt k)
 {
     Vertex x;
     
@@ -465,12 +723,13 @@ unrollArc(Arc **L, Vertex *e, UInt *d, Arc *a, UInt k)
     if (k & HC_ENDPOINT) {
         x = a->cross->target;
         insertArc(L + x, a);
-        e[x] = 0;
+        if (rk) keyArc(rk, x, a->target);
+        setVirtualEdge(rk, e, x, 0);
     } else if (k & HC_FORCED) {
         x    = a->cross->target;
-        e[e[x]] = x;
-        d[x]    = (k & HC_FORCED_DEG2)? 
-                      restoreInArcsWithCount(L, a, d) + 2 : 2;
+        setVirtualEdge(rk, e, e[x], x);
+        setDegree(rk, d, x, (k & HC_FORCED_DEG2) ? 
+                      restoreInArcsWithCount(rk, L, a, d) + 2 : 2);
     }
     
 } /* unrollArc */
@@ -478,11 +737,13 @@ unrollArc(Arc **L, Vertex *e, UInt *d, Arc *a, UInt k)
 
 
 static inline Vertex *
-removeInArcs(Arc **L, Arc *a, UInt *d, Vertex *d2)
+removeInArcs(HCKey *rk, Arc **L, Arc *a, UInt *d, Vertex *d2)
 {
     Vertex  x;
     Arc   *p = a->prev;
     
+    if (rk) keyInArcs(rk, a);
+    
     while (p != a) {
         x = p->target;
         if (--d[x] == 2) *(++d2) = x;
@@ -500,7 +761,7 @@ removeInArcs(Arc **L, Arc *a, UInt *d, Vertex *d2)
    a consistant state. */
 
 static inline bool
-extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
+extendAnchor(HCStateRef s, HCKey *rk, Arc **L, Vertex *e, UInt *d, Vertex x)
 {
     Vertex   y, ex;
     Arc    *a;
@@ -508,6 +769,9 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
 
     Vertex  *d2 = s->deg2Stack;
     
+    HC_STAT_INC(s, anchors);
+    HC_TRACE_EVENT(s, HC_TRACE_ANCHOR, x, s->pos);
+    
     if ((ex = e[x])){
     
     /* case 1: source vertex of current arc is already on a virtual edge 
@@ -519,7 +783,7 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
         a    = L[x];
         k    = HC_ANCHOR_POINT | HC_ANCHOR_EXTEND;
         d[x] = 0;
-        return extendSegments(s, a, ex, k, removeInArcs(L, a, d, d2));
+        return extendSegments(s, rk, a, ex, k, removeInArcs(rk, L, a, d, d2));
         
     } 
     
@@ -537,7 +801,7 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
         s->removedEdges         = NULL;
         
         d[y] = 0;
-        if (!extendSegments(s, a, ex, k, removeInArcs(L, a, d, d2)))
+        if (!extendSegments(s, rk, a, ex, k, removeInArcs(rk, L, a, d, d2)))
             return false;
         
         if (!d[x]) return true;
@@ -548,7 +812,8 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
         a    = L[x];
         d[x] = 0;
         k    = HC_ANCHOR_POINT | HC_ANCHOR_EXTEND;
-        return extendSegments(s, a, e[x], k, removeInArcs(L, a, d, d2));
+        return extendSegments(s, rk, a, e[x], k, 
+                              removeInArcs(rk, L, a, d, d2));
         
     }
     
@@ -559,9 +824,10 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
     
     removeArc(L + y, a->cross);
     removeArc(L + x, a);
+    if (rk) keyEdge(rk, x, y);
     
-    e[x] = y;
-    e[y] = x;
+    setVirtualEdge(rk, e, x, y);
+    setVirtualEdge(rk, e, y, x);
     
     s->pos++;
     s->pos->arc    = a->cross;
@@ -574,29 +840,182 @@ extendAnchor(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex x)
     d[x] = 0;
     k    = HC_ANCHOR_POINT | HC_ANCHOR_EXTEND;
     
-    return extendSegments(s, a, y, k, removeInArcs(L, a, d, d2));    
+    return extendSegments(s, rk, a, y, k, removeInArcs(rk, L, a, d, d2));    
     
 } /* extendAnchor */
 
 
-/*! Process required edges, and insert any initial segment focal points 
-(degree 2 vertices).  Returns true only if runTurningMachine can
-be entered.  This could be due to an unreported hamilton cycle, or a 
-halting conditon may have occured (degree < 2 and not in a segment)  */
+/*! The arc from x to y, NULL if the edge is not in the graph. */
 
-static Vertex
-primeTape(HCStateRef s)
+static inline Arc *
+findArc(Arc **L, Vertex x, Vertex y)
+{
+    Arc   *a;
+    
+    for (a = L[x]; a && a->target != y; a = a->next) ;
+    return a;
+} /* findArc */
+
+
+/*! Remove both arcs of the edge held by a for the rest of the search, 
+restoreGraph puts them back. */
+
+static inline void
+dropEdge(HCStateRef s, Arc **L, UInt *d, Arc *a)
+{
+    Vertex   x = a->cross->target;
+    Vertex   y = a->target;
+    
+    removeArc(L + x, a);
+    removeArc(L + y, a->cross);
+    d[x]--;
+    d[y]--;
+    
+    a->next         = s->removedEdges;
+    s->removedEdges = a;
+} /* dropEdge */
+
+
+/*! Apply the constraints of setHCEdgeConstraints to the graph before the 
+tape is primed.  Forbidden edges are removed.  A vertex on two required 
+edges loses its other edges, it then has degree 2 and is forced onto a 
+segment by forceDegreeTwoVertices.  A required edge whose ends are on 
+no other required edge is placed as a virtual edge, with a tape entry 
+marked HC_ANCHOR_POINT | HC_TERMINATE so that the search never rotates 
+it and restoreGraph removes it again.  Returns false when no cycle can 
+meet the constraints: a required edge is missing (or forbidden) or a 
+vertex is on three required edges. 
+
+While the required edges are counted e[x] holds the single required 
+neighbour of x, or x itself once it has two. */
+
+static bool
+applyEdgeConstraints(HCStateRef s)
+{
+    Vertex   x, y, *r;
+    Arc     *a, *n;
+    UInt     i, j;
+    
+    Arc    **L   = s->adjList;
+    UInt    *d   = s->degree;
+    Vertex  *e   = s->virtualEdge;
+    Vertex   pts = s->vertexCount;
+    Arc     *req = NULL;
+    
+    for (i = 0, r = s->forbidden; i < s->forbiddenCount; i++, r += 2) {
+        x = r[0];
+        y = r[1];
+        if (x < 1 || x > pts || y < 1 || y > pts) continue;
+        if ((a = findArc(L, x, y))) dropEdge(s, L, d, a);
+    }
+    
+    /* take the required edges out of the graph while counting them, a 
+       repeated edge is no longer found and is skipped */
+    
+    for (i = 0, r = s->required; i < s->requiredCount; i++, r += 2) {
+        x = r[0];
+        y = r[1];
+        a = (x >= 1 && x <= pts && y >= 1 && y <= pts) ? 
+                findArc(L, x, y) : NULL;
+        
+        if (!a) {
+            for (j = 0; j < i; j++) {
+                if ((s->required[2*j] == x && s->required[2*j+1] == y) ||
+                    (s->required[2*j] == y && s->required[2*j+1] == x))
+                    break;
+            }
+            if (j == i) goto infeasible;
+            continue;
+        }
+        
+        if (e[x] == x || e[y] == y) goto infeasible;
+        
+        e[x] = e[x] ? x : y;
+        e[y] = e[y] ? y : x;
+        
+        removeArc(L + x, a);
+        removeArc(L + y, a->cross);
+        d[x]--;
+        d[y]--;
+        
+        a->next = req;
+        req     = a;
+    }
+    
+    for (a = req; a; a = a->next) {
+        x = a->cross->target;
+        y = a->target;
+        while (e[x] == x && L[x]) dropEdge(s, L, d, L[x]);
+        while (e[y] == y && L[y]) dropEdge(s, L, d, L[y]);
+    }
+    
+    /* put the required edges back, as virtual edges where both ends are
+       free, as arcs of the degree 2 vertices otherwise */
+    
+    for (a = req; a; a = n) {
+        n = a->next;
+        x = a->cross->target;
+        y = a->target;
+        d[x]++;
+        d[y]++;
+        
+        if (e[x] == y && e[y] == x) {
+        
+            *s->removedEdgesStack++ = s->removedEdges;
+            s->removedEdges         = NULL;
+            
+            s->pos++;
+            s->pos->arc    = a->cross;
+            s->pos->status = HC_ANCHOR_POINT | HC_TERMINATE;
+            
+        } else {
+        
+            insertArc(L + x, a);
+            insertArc(L + y, a->cross);
+            e[x] = 0;
+            e[y] = 0;
+        }
+    }
+    
+    return true;
+    
+infeasible:
+
+    /* leave the edges taken out for restoreGraph */
+    
+    for (a = req; a; a = n) {
+        n               = a->next;
+        a->next         = s->removedEdges;
+        s->removedEdges = a;
+    }
+    memset(e, 0, sizeof(Vertex) * (pts + 1));
+    
+    return false;
+    
+} /* applyEdgeConstraints */
+
+
+/*! Apply the edge constraints, check for vertices of degree < 2 and force
+the degree 2 vertices onto segments.  Returns true only if anchors can 
+be placed, false when the constraints cannot be met, a vertex of 
+degree < 2 or a cycle (s->flags.isHamiltonCycle tells if it is a 
+Hamilton cycle) ends the search. */
+
+static bool
+forceDegreeTwoVertices(HCStateRef s)
 {
     UInt     dx;
     Vertex   ex;
     
     Vertex   x  = s->vertexCount + 1;
     Arc   **L  = s->adjList;
-    Vertex  *e  = s->virtualEdge;
     UInt    *d  = s->degree;
-    Vertex  *nv = s->vertexOrder;
+    Vertex  *e  = s->virtualEdge;
     Vertex  *d2 = s->deg2Stack;
     
+    if ((s->requiredCount || s->forbiddenCount) && 
+        !applyEdgeConstraints(s)) return false;
+    
     /* check for any degree 2 vertices, or stop condition */
     
     while (--x){
@@ -614,29 +1033,54 @@ primeTape(HCStateRef s)
             d[x] = 0;
         } else ex = x;
         
-        if (!extendSegments(s, L[x], ex, 0, --d2))
-            return !s->flags.isHamiltonCycle;     
+        return extendSegments(s, NULL, L[x], ex, 0, --d2);
     } 
     
+    return true;
+    
+} /* forceDegreeTwoVertices */
+
+
+/*! Process required edges, and insert any initial segment focal points 
+(degree 2 vertices).  Returns true only if runTurningMachine can
+be entered.  This could be due to an unreported hamilton cycle, or a 
+halting conditon may have occured (degree < 2 and not in a segment)  */
+
+static Vertex
+primeTape(HCStateRef s)
+{
+    Vertex   x;
+    
+    Arc   **L  = s->adjList;
+    Vertex  *e  = s->virtualEdge;
+    UInt    *d  = s->degree;
+    Vertex  *nv = s->vertexOrder;
+    
+    if (!forceDegreeTwoVertices(s)) return false;
+    
     /* repeatedly place pivot vertices until stop condition reached */
     x = 0;
     do {
         do x = nv[x]; while (!d[x]);
-    } while (extendAnchor(s, L, e, d, x));
+    } while (extendAnchor(s, NULL, L, e, d, x));
     
+    HC_STAT_DEPTH(s);
     return !s->flags.isHamiltonCycle;
     
 } /* primeTape */
 
 
 static inline HCTape *
-unwindSearchEdge(Arc **L, Vertex *e, UInt *d, HCTape *hx)
+unwindSearchEdge(HCStateRef s, HCKey *rk, Arc **L, Vertex *e, UInt *d, 
+                 HCTape *hx)
 {
     
     UInt         k = hx->status;
     Vertex       x;
     Arc        *a;
     
+    HC_STAT_INC(s, unwinds);
+    
     /* roll back graph state to closest pivot point */
     while(!(k & (HC_ANCHOR_POINT | HC_TERMINATE))) {
     
@@ -647,16 +1091,18 @@ unwindSearchEdge(Arc **L, Vertex *e, UInt *d, HCTape *hx)
     
         /* restore vertex */
 
-        unrollArc(L, e, d, a, k);
+        unrollArc(rk, L, e, d, a, k);
         
-        d[x]    = 2;
-        e[e[x]] = x;
+        setDegree(rk, d, x, 2);
+        setVirtualEdge(rk, e, e[x], x);
         
         /* move tape head to the left and restart loop */
         hx--;
         k = hx->status;
     }
     
+    HC_TRACE_EVENT(s, HC_TRACE_UNWIND, 
+                   hx > s->origin ? hx->arc->target : 0, hx);
     return hx;
     
 } /* unwindSearchEdge */
@@ -664,7 +1110,7 @@ unwindSearchEdge(Arc **L, Vertex *e, UInt *d, HCTape *hx)
 
 
 static inline Vertex
-rotateAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,
+rotateAnchorPoint(HCStateRef s, HCKey *rk, Arc **L, Vertex *e, UInt *d,
  HCTape *hx, Vertex **d2Ptr)
 {
     Vertex  *d2 = s->deg2Stack;
@@ -673,25 +1119,38 @@ rotateAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,
     Vertex   x  = a->target;
     Arc    *c  = a->cross;
     Vertex   y  = c->target;
+    UInt    *b;
 
+    /* count the sibling, positions to the right start new branch points, 
+       clearing them costs no more than the unwind that led here */
+    
+    if (s->flags.tracksProgress) {
+        b = s->branch + (hx - s->origin);
+        while (s->branchTop > b) *s->branchTop-- = 0;
+        (*b)++;
+        s->branchTop = b;
+    }
+    if (hx < s->lowest) s->lowest = hx;
+    
     if (k & HC_ANCHOR_EXTEND) {
-        unrollArc(L, e, d, a, k);
+        unrollArc(rk, L, e, d, a, k);
         
-        e[e[x]] = x;
-        d[x]    = 2 + restoreInArcsWithCount(L, c, d);
+        setVirtualEdge(rk, e, e[x], x);
+        setDegree(rk, d, x, 2 + restoreInArcsWithCount(rk, L, c, d));
         
         removeArc(L + x, c);
         removeArc(L + y, a);
+        if (rk) keyEdge(rk, x, y);
 
     } else {
 
-        e[x] = 0;
-        e[y] = 0;
+        setVirtualEdge(rk, e, x, 0);
+        setVirtualEdge(rk, e, y, 0);
     }
     
     /* Restore edges removed during previous branch */
     
-    restoreEdges(L, s->removedEdges, d);
+    restoreEdges(rk, L, s->removedEdges, d);
     
     /* Remove the edge current pivot point represents and give it 
     to the closest pivot point to the left to restore.  This indicates
@@ -716,7 +1175,8 @@ rotateAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,
 
 
 static inline void
-restoreAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,HCTape *hx)
+restoreAnchorPoint(HCStateRef s, HCKey *rk, Arc **L, Vertex *e, UInt *d,
+                   HCTape *hx)
 {
     UInt    k = hx->status;
     Arc   *a = hx->arc;
@@ -726,24 +1186,25 @@ restoreAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,HCTape *hx)
 
     if (k & HC_ANCHOR_EXTEND) {
 
-        unrollArc(L, e, d, a, k);
+        unrollArc(rk, L, e, d, a, k);
 
-        e[e[x]] = x;
-        d[x]    = 2 + restoreInArcsWithCount(L, c, d);
+        setVirtualEdge(rk, e, e[x], x);
+        setDegree(rk, d, x, 2 + restoreInArcsWithCount(rk, L, c, d));
         
     } else {
         
-        e[x] = 0;
-        e[y] = 0;
+        setVirtualEdge(rk, e, x, 0);
+        setVirtualEdge(rk, e, y, 0);
         
         insertArc(L + x, c);
         insertArc(L + y, a);
+        if (rk) keyEdge(rk, x, y);
         
     }
 
     /* Restore edges removed during previous branch */
 
-    restoreEdges(L, s->removedEdges, d);
+    restoreEdges(rk, L, s->removedEdges, d);
     s->removedEdges  = *--s->removedEdgesStack;
     
 } /* restoreAnchorPoint */
@@ -751,8 +1212,8 @@ restoreAnchorPoint(HCStateRef s, Arc **L, Vertex *e, UInt *d,HCTape *hx)
 
 
 static inline Vertex
-ensureConsistent(HCStateRef s, Arc **L, Vertex *e, UInt *d, Vertex *d2, 
-Vertex x, Vertex *nv)
+ensureConsistent(HCStateRef s, HCKey *rk, Arc **L, Vertex *e, UInt *d, 
+Vertex *d2, Vertex x, Vertex *nv)
 {
     Vertex ey;
     Vertex y  = *d2;
@@ -768,7 +1229,7 @@ Vertex x, Vertex *nv)
     }
     else ey = y;
     
-    if (!extendSegments(s, L[y], ey, 0, --d2)) return 0;
+    if (!extendSegments(s, rk, L[y], ey, 0, --d2)) return 0;
     
     /* x may have been absorbed by a segment, ensure return of next
     available pivot */
@@ -782,6 +1243,53 @@ Vertex x, Vertex *nv)
 
 
 
+/*! Set the next rotation count at which the limits are checked, the 
+earlier of the rotation limit and the next clock reading. */
+
+static void
+setCheckpoint(HCStateRef s)
+{
+    s->checkpoint = s->rotationLimit;
+    
+    if (s->deadline > 0 && s->clockCheck < s->checkpoint)
+        s->checkpoint = s->clockCheck;
+        
+} /* setCheckpoint */
+
+
+
+/*! Slow path of searchInterrupted, taken only at a checkpoint. */
+
+static bool
+searchLimitReached(HCStateRef s)
+{
+    if (s->rotations >= s->rotationLimit) return true;
+    
+    if (s->deadline > 0) {
+        if (monotonicSeconds() >= s->deadline) return true;
+        s->clockCheck = s->rotations + HC_CLOCK_INTERVAL;
+    }
+    
+    setCheckpoint(s);
+    return false;
+    
+} /* searchLimitReached */
+
+
+
+/*! True once a search limit is reached or another thread has asked for
+the search to stop.  Outside of checkpoints this is a compare and a 
+relaxed load, no more than a couple of ordinary reads. */
+
+static inline bool
+searchInterrupted(HCStateRef s)
+{
+    return (s->rotations >= s->checkpoint && searchLimitReached(s))
+        || atomic_load_explicit(&s->cancelled, memory_order_relaxed);
+} /* searchInterrupted */
+
+
+
 /* return true if unwound all the way back to initial graph state */
 
 static HCTape*
@@ -796,6 +1304,8 @@ pruneSearchSpace(HCStateRef s, SInt c)
     HCTape  *stop = hx = s->pos;
     UInt     k    = stop->status;
     
+    HC_STAT_INC(s, prunes);
+    
     while (!(k & HC_TERMINATE) && (c > 0)) {
         if (k & HC_ANCHOR_TYPE1) c--;
         if (k & HC_ANCHOR_POINT) c--;
@@ -806,11 +1316,12 @@ pruneSearchSpace(HCStateRef s, SInt c)
     } 
     
     stop++;
+    HC_TRACE_EVENT(s, HC_TRACE_PRUNE, stop->arc->target, stop);
     
-    hx = unwindSearchEdge(L, e, d, hx);
+    hx = unwindSearchEdge(s, NULL, L, e, d, hx);
     while (hx > stop) {
-        restoreAnchorPoint(s, L, e, d, hx);
-        hx = unwindSearchEdge(L, e, d, hx - 1);
+        restoreAnchorPoint(s, NULL, L, e, d, hx);
+        hx = unwindSearchEdge(s, NULL, L, e, d, hx - 1);
     }
 
     return hx;
@@ -902,14 +1413,22 @@ runTuringMachineWithPruning(HCStateRef s)
     Vertex  *e  = s->virtualEdge;
     Vertex  *nv = s->vertexOrder;
     Arc   **L  = s->adjList; 
-    HCTape  *hx = unwindSearchEdge(L, e, d, s->pos); 
+    HCTape  *hx = unwindSearchEdge(s, NULL, L, e, d, s->pos); 
 
     s->flags.isHamiltonCycle = false;
 
     while (!(hx->status & HC_TERMINATE)) {
     
-        x1 = rotateAnchorPoint(s, L, e, d, hx, &d2);
-        x  = ensureConsistent(s, L, e, d, d2, x1, nv);
+        if (searchInterrupted(s)) {
+            s->pos    = hx;
+            s->status = HC_SEARCH_UNDECIDED;
+            return false;
+        }
+        
+        s->rotations++;
+        
+        x1 = rotateAnchorPoint(s, NULL, L, e, d, hx, &d2);
+        x  = ensureConsistent(s, NULL, L, e, d, d2, x1, nv);
         
         if (x){
 
@@ -927,19 +1446,26 @@ runTuringMachineWithPruning(HCStateRef s)
                 prune = false;
             }
 
-            while (extendAnchor(s, L, e, d, x)){
+            while (extendAnchor(s, NULL, L, e, d, x)){
                 do x = nv[x]; while (!d[x]);
             }
         }
         
-        if (s->flags.isHamiltonCycle) return true;
-        hx   = unwindSearchEdge(L, e, d, s->pos); 
+        HC_STAT_DEPTH(s);
+        
+        if (s->flags.isHamiltonCycle) {
+            s->status = HC_SEARCH_CYCLE;
+            s->cycles++;
+            return true;
+        }
+        hx   = unwindSearchEdge(s, NULL, L, e, d, s->pos); 
     
         if (hx > high) high = hx;
         else prune = hx < high;
     }
     
-    s->pos = hx;
+    s->pos    = hx;
+    s->status = HC_SEARCH_EXHAUSTED;
     return false; 
     
 } /* runTuringMachineWithPruning */
@@ -955,24 +1481,39 @@ runTuringMachine(HCStateRef s)
     Vertex  *e  = s->virtualEdge;
     Vertex  *nv = s->vertexOrder;
     Arc   **L  = s->adjList; 
-    HCTape  *hx = unwindSearchEdge(L, e, d, s->pos); 
+    HCTape  *hx = unwindSearchEdge(s, NULL, L, e, d, s->pos); 
     s->flags.isHamiltonCycle = false;
 
     while (!(hx->status & HC_TERMINATE)) {
     
-        x  = rotateAnchorPoint(s, L, e, d, hx, &d2);
-        x  = ensureConsistent(s, L, e, d, d2, x, nv);
+        if (searchInterrupted(s)) {
+            s->pos    = hx;
+            s->status = HC_SEARCH_UNDECIDED;
+            return false;
+        }
+        
+        s->rotations++;
+        
+        x  = rotateAnchorPoint(s, NULL, L, e, d, hx, &d2);
+        x  = ensureConsistent(s, NULL, L, e, d, d2, x, nv);
         if (x){
-            while (extendAnchor(s, L, e, d, x)){
+            while (extendAnchor(s, NULL, L, e, d, x)){
                 do x = nv[x]; while (!d[x]);
             }
         }
         
-        if (s->flags.isHamiltonCycle) return true;
-        hx  = unwindSearchEdge(L, e, d, s->pos); 
+        HC_STAT_DEPTH(s);
+        
+        if (s->flags.isHamiltonCycle) {
+            s->status = HC_SEARCH_CYCLE;
+            s->cycles++;
+            return true;
+        }
+        hx  = unwindSearchEdge(s, NULL, L, e, d, s->pos); 
     }
     
-    s->pos = hx;
+    s->pos    = hx;
+    s->status = HC_SEARCH_EXHAUSTED;
     return false; 
     
 } /* runTuringMachine */
@@ -986,14 +1527,17 @@ restoreGraph(HCStateRef s)
     UInt        *d  = s->degree;    
     Vertex      *e  = s->virtualEdge;
     Arc       **L  = s->adjList; 
-    HCTape  *hx = unwindSearchEdge(L, e, d, s->pos);
+    HCTape  *hx = unwindSearchEdge(s, NULL, L, e, d, s->pos);
 
-    while (!(hx->status & HC_TERMINATE)) {
-        restoreAnchorPoint(s, L, e, d, hx);
-        hx = unwindSearchEdge(L, e, d, hx - 1);
+    /* the required edges placed by applyEdgeConstraints are anchors
+       marked HC_TERMINATE above the origin */
+
+    while (hx > s->origin) {
+        restoreAnchorPoint(s, NULL, L, e, d, hx);
+        hx = unwindSearchEdge(s, NULL, L, e, d, hx - 1);
     }
     
-    restoreEdges(L, s->removedEdges, d);
+    restoreEdges(NULL, L, s->removedEdges, d);
         
 } /* restoreGraph */
 
@@ -1012,6 +1556,8 @@ resetStateAndRestoreGraph(HCStateRef s)
     
     memset(s->virtualEdge, 0, sizeof(Vertex) * (s->vertexCount + 1));
     memset(s->origin, 0, (s->vertexCount + 2) * sizeof(HCTape));
+    memset(s->branch, 0, (s->vertexCount + 2) * sizeof(UInt));
+    s->branchTop = s->branch;
     
     s->pos = s->origin;
     s->pos[s->vertexCount+1].status = HC_HAMILTONIAN;
@@ -1042,12 +1588,17 @@ Hamilton cycle found. */
 bool
 firstHamiltonianCycle(HCStateRef s)
 {
+    s->flags.isPrimed = true;
+    s->cycles         = 0;
     resetStateAndRestoreGraph(s);
     
-    if (primeTape(s) 
-         && !runTuringMachine(s)) return false;
+    if (!primeTape(s)) {
+        if (s->flags.isHamiltonCycle) s->cycles++;
+    } else if (!runTuringMachine(s)) return false;
     
     s->flags.isHamiltonian = s->flags.isHamiltonCycle;
+    s->status = s->flags.isHamiltonCycle ? 
+                    HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
     
     return s->flags.isHamiltonCycle;
     
@@ -1071,12 +1622,17 @@ Hamilton cycle found. */
 bool
 firstHamiltonianCycleWithPruning(HCStateRef s)
 {
+    s->flags.isPrimed = true;
+    s->cycles         = 0;
     resetStateAndRestoreGraph(s);
     
-    if (primeTape(s) 
-         && !runTuringMachineWithPruning(s)) return false;
+    if (!primeTape(s)) {
+        if (s->flags.isHamiltonCycle) s->cycles++;
+    } else if (!runTuringMachineWithPruning(s)) return false;
     
     s->flags.isHamiltonian = s->flags.isHamiltonCycle;
+    s->status = s->flags.isHamiltonCycle ? 
+                    HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
     
     return s->flags.isHamiltonCycle;
     
@@ -1084,71 +1640,1095 @@ firstHamiltonianCycleWithPruning(HCStateRef s)
 
 
 
-HCStateRef
-allocateHCState(UInt points, StatusRef status)
+/*! Link the vertices of vo into the anchor order list. */
+
+static void
+setVertexOrder(HCStateRef s, VArray *vo)
 {
-    HCStateRef s;
-    UInt       n = 1 + points;
+    Vertex *nv, *vl, x;
     
-    CHECK_RETURN_VAL(*status, NULL);
-
-    EM(s,                     sizeof(struct hc_state),           e0);
-    EM(s->virtualEdge,        n * sizeof(Vertex),              e1);
-    EM(s->deg2Stack,          n * sizeof(Vertex),              e2);
-    EM(s->removedEdgesStack,  n * sizeof(void *),              e3);
-    EM(s->pos,                (points + 2) * sizeof(HCTape),     e4);
-    EM(s->vertexOrder,        n * sizeof(Vertex),              e5);
+    nv  = s->vertexOrder;
+    vl  = vo->array;
+    *nv = *vo->array;
+    for (x = 1 ; x < (Vertex)s->vertexCount ; x++) nv[vl[x-1]] = vl[x];
     
-    s->dfs         = allocateDFS(points);
-    s->vertexCount = points;
+    /* mark the end of the list, allows for a vertex remaining count */
+    nv[ vl[x-1] ] = 0;        
     
-    if (!s->dfs) goto e6;
+} /* setVertexOrder */
 
-    return s;
 
-e6: free(s->vertexOrder);
-e5: free(s->pos);
-e4: free(s->removedEdgesStack);
-e3: free(s->deg2Stack);
-e2: free(s->virtualEdge);
-e1:    free(s);
+/*! Copy the anchor order list into vo. */
+
+static void
+getVertexOrder(HCStateRef s, VArray *vo)
+{
+    Vertex *nv = s->vertexOrder;
+    Vertex *vl = vo->array;
+    Vertex  x  = 0;
     
-e0:    *status = STATUS_NO_MEM;
-    return NULL;
+    while ((x = nv[x])) *vl++ = x;
     
-} /* allocHCState */
+} /* getVertexOrder */
 
 
-HCStateRef
-initHCState(HCStateRef s, UInt *d, Arc **adj, VArray *vo)
+/* i-th term (from 1) of the Luby sequence 1 1 2 1 1 2 4 1 1 2 ... */
+
+static ULongLong
+luby(ULongLong i)
 {
+    ULongLong k;
+    
+    for (;;) {
+        for (k = 1; (1ULL << k) - 1 < i; k++);
+        if (i == (1ULL << k) - 1) return 1ULL << (k - 1);
+        i -= (1ULL << (k - 1)) - 1;
+    }
+} /* luby */
 
-    Vertex *nv, *vl, x;
 
-    s->adjList            = adj;
+
+/*! Decide if the graph is Hamiltonian using randomized restarts.
+
+Run i (from 1) shuffles the arc lists and the ties of the descending 
+degree anchor order using the i-th seed drawn from a generator seeded 
+with seed, then 
+searches for at most unit * luby(i) anchor rotations.  A run that ends
+before its budget decides the question, a cycle found or the search space
+exhausted. After restarts undecided runs a final run with the original 
+anchor order and no budget is made to settle the question.
+
+The same seed always produces the same sequence of runs. The arc lists
+of the graph are left in the order of the last shuffle. Returns false 
+when no Hamilton cycle exists, or the search was cancelled. */
+
+bool
+firstHamiltonianCycleWithRestarts(HCStateRef s, ULongLong seed, 
+    ULongLong unit, UInt restarts, bool prune)
+{
+    VArray       orig, vo;
+    Arc        **buf;
+    RandomState  master, r;
+    Vertex       x;
+    UInt         i;
+    bool         found;
+    
+    UInt         pts   = s->vertexCount;
+    ULongLong    limit = s->rotationLimit;
+    ULongLong    run;
+    
+    EM(orig.array, pts * sizeof(Vertex), e0);
+    EM(vo.array,   pts * sizeof(Vertex), e1);
+    EM(buf,        pts * sizeof(Arc *),  e2);
+    
+    orig.length = vo.length = pts;
+    getVertexOrder(s, &orig);
+    seedRandom(&master, seed);
+    
+    for (i = 1; i <= restarts; i++) {
+    
+        resetStateAndRestoreGraph(s);
+        seedRandom(&r, nextRandom(&master));
+        
+        memcpy(vo.array, orig.array, pts * sizeof(Vertex));
+        sortVerticesDegreeDesc(shuffleVertices(&vo, &r), s->degree);
+        setVertexOrder(s, &vo);
+        
+        for (x = 1; x <= (Vertex)pts; x++) 
+            shuffleArcs(s->adjList + x, buf, &r);
+        
+        run              = s->rotations + unit * luby(i);
+        s->rotationLimit = run < limit ? run : limit;
+        setCheckpoint(s);
+        
+        found = prune ? firstHamiltonianCycleWithPruning(s)
+                      : firstHamiltonianCycle(s);
+        
+        /* stop unless only the budget of this run was exhausted */
+        
+        if (s->status != HC_SEARCH_UNDECIDED 
+              || s->rotations < run
+              || run >= limit) goto done;
+    }
+    
+    /* complete run, proves the graph is not Hamiltonian if no cycle */
+    
+    setVertexOrder(s, &orig);
+    s->rotationLimit = limit;
+    setCheckpoint(s);
+    
+    found = prune ? firstHamiltonianCycleWithPruning(s)
+                  : firstHamiltonianCycle(s);
+    
+done:
+    s->rotationLimit = limit;
+    setCheckpoint(s);
+    
+    free(buf);
+    free(vo.array);
+    free(orig.array);
+    return found;
+    
+e2: free(vo.array);
+e1: free(orig.array);
+e0: return prune ? firstHamiltonianCycleWithPruning(s) 
+                 : firstHamiltonianCycle(s);
+    
+} /* firstHamiltonianCycleWithRestarts */
+
+
+
+/*! Move a random one of the first k arcs of the list Lx to its front. */
+
+static void
+moveRandomArcToFront(Arc **Lx, UInt k, RandomState *r)
+{
+    UInt    j = randomBelow(r, k);
+    Arc    *a = *Lx;
+    
+    if (!j) return;
+    
+    while (j--) a = a->next;
+    
+    removeArc(Lx, a);
+    insertArc(Lx, a);
+    
+} /* moveRandomArcToFront */
+
+
+/*! One random root to leaf probe of the search tree.  Anchors that are
+segment endpoints branch on their arcs, an anchor x that is not is 
+first replaced by its first neighbour y when y is an endpoint, else it
+branches on keeping the edge xy (then on the second arc of x) or 
+removing it.  Returns the product of the branching factors along the 
+path if the leaf is a Hamilton cycle and 0 otherwise, *nodes is set to 
+the sum of the partial products, the number of branch points. The 
+graph is left for resetStateAndRestoreGraph to restore. */
+
+static double
+probeSearchTree(HCStateRef s, RandomState *r, double *nodes)
+{
+    Vertex   x, y;
+    Arc     *a;
+    UInt     k;
+    bool     more;
+    
+    double   w  = 1.0;
+    Arc    **L  = s->adjList;
+    Vertex  *e  = s->virtualEdge;
+    UInt    *d  = s->degree;
+    Vertex  *nv = s->vertexOrder;
+    Vertex  *d2 = s->deg2Stack;
+    
+    *nodes = 1.0;
+    more   = forceDegreeTwoVertices(s);
+    x      = nv[0];
+    
+    while (more) {
+    
+        while (!d[x]) x = nv[x];
+        
+        a = L[x];
+        y = a->target;
+        
+        if (!e[x] && e[y]) x = y;
+        
+        if (e[x]) {
+        
+            /* endpoint, one branch per arc, the segment edge is not 
+               in the list */
+               
+            k  = d[x] - 1;
+            w *= k;
+            moveRandomArcToFront(L + x, k, r);
+            more = extendAnchor(s, NULL, L, e, d, x);
+            
+        } else if (randomBelow(r, 2)) {
+        
+            /* keep xy, then pick the second edge of x */
+            
+            k  = d[x] - 1;
+            w *= 2 * k;
+            removeArc(L + x, a);
+            moveRandomArcToFront(L + x, k, r);
+            insertArc(L + x, a);
+            more = extendAnchor(s, NULL, L, e, d, x);
+            
+        } else {
+        
+            /* remove xy, both ends keep degree >= 2 as the graph is 
+               consistent, then force any degree 2 vertices */
+            
+            w *= 2;
+            removeArc(L + x, a);
+            removeArc(L + y, a->cross);
+            a->next         = s->removedEdges;
+            s->removedEdges = a;
+            
+            d2 = s->deg2Stack;
+            if (--d[x] == 2) *(++d2) = x;
+            if (--d[y] == 2) *(++d2) = y;
+            
+            x    = ensureConsistent(s, NULL, L, e, d, d2, x, nv);
+            more = x != 0;
+        }
+        
+        *nodes += w;
+    }
+    
+    return s->flags.isHamiltonCycle ? w : 0.0;
+    
+} /* probeSearchTree */
+
+
+/*! Knuth's estimate of the size of the search tree and of the number of
+Hamilton cycles from probes random root to leaf probes, seeded with 
+seed.  Each probe is an unbiased estimate, est holds their means and the
+half widths of the 95% confidence intervals (normal approximation).
+
+The tree probed takes a branch per arc at segment endpoints where the 
+search rotates through the arcs one at a time, its node count is a 
+guide to the work of an unpruned search rather than an exact rotation 
+count.  The state is left as after initHCState, the arc lists of the 
+graph in a different order. */
+
+void
+estimateHamiltonianCycles(HCStateRef s, ULongLong probes, ULongLong seed,
+    HCEstimate *est)
+{
+    RandomState  r;
+    ULongLong    i;
+    double       c, n, m;
+    
+    double       sc = 0, sc2 = 0, sn = 0, sn2 = 0;
+    
+    seedRandom(&r, seed);
+    
+    for (i = 0; i < probes; i++) {
+        resetStateAndRestoreGraph(s);
+        c    = probeSearchTree(s, &r, &n);
+        sc  += c;
+        sc2 += c * c;
+        sn  += n;
+        sn2 += n * n;
+    }
+    
+    resetStateAndRestoreGraph(s);
+    s->flags.isPrimed = false;
+    s->status         = HC_SEARCH_EXHAUSTED;
+    
+    m                = probes ? (double)probes : 1.0;
+    est->probes      = probes;
+    est->cycles      = sc / m;
+    est->nodes       = sn / m;
+    est->cyclesError = est->nodesError = 0.0;
+    
+    if (probes > 1) {
+        est->cyclesError = 1.96 * sqrt(fmax(0.0, 
+                            (sc2 - sc * sc / m) / (m - 1)) / m);
+        est->nodesError  = 1.96 * sqrt(fmax(0.0, 
+                            (sn2 - sn * sn / m) / (m - 1)) / m);
+    }
+    
+} /* estimateHamiltonianCycles */
+
+
+
+/* seed of the random vertex values hashed into residual graph keys */
+
+#define HC_MEMO_SEED  0x5eed5eedULL
+
+/*! A subtree of the counting search whose count is not yet known. */
+
+typedef struct hc_memo_frame {
+    UInt       depth;      /* tape position the subtree was entered at */
+    ULongLong  key;
+    ULongLong  check;
+    ULongLong  cycles;     /* cycles counted before entering it */
+} HCMemoFrame;
+
+typedef struct hc_memo {
+    MemoTableRef  table;
+    HCMemoFrame  *frame;
+    UInt          top;
+    UInt          size;
+    ULongLong     cycles;
+    HCKey         residual;   /* key of the residual graph at the tape */
+} HCMemo;
+
+
+/*! Hash the residual graph: the vertices still on the graph, the edges
+joining them and the virtual edges joining segment endpoints.  Every
+tape prefix that leaves the same residual graph has the same number of
+completions to a Hamilton cycle, the tape length being fixed by it. 
+Two independent 64 bit hashes are taken to make collisions negligible.
+The terms of each vertex are XORed into rk->vertexKey, those of the 
+vertices on the graph into rk->key and rk->check, which the tape 
+primitives then keep up to date from one scan here. */
+
+static void
+residualKey(HCStateRef s, HCKey *rk)
+{
+    Vertex     x, y;
+    Arc       *a;
+    ULongLong *v;
+    
+    Arc      **L  = s->adjList;
+    UInt      *d  = s->degree;
+    Vertex    *e  = s->virtualEdge;
+    ULongLong *z  = rk->zobrist;
+    UInt       n  = s->vertexCount;
+    
+    rk->degree = d;
+    rk->key    = 0;
+    rk->check  = 0;
+    
+    rk->vertexKey[0] = rk->vertexKey[1] = 0;
+    
+    for (x = 1; x <= (Vertex)n; x++) {
+        v    = rk->vertexKey + 2 * x;
+        v[0] = z[2 * x];
+        v[1] = z[2 * x + 1];
+        
+        if ((y = e[x]) > x) {
+            v[0] ^= mixKey(z[2 * x] + 3 * z[2 * y] + 1);
+            v[1] ^= mixKey(z[2 * x + 1] + 3 * z[2 * y + 1] + 1);
+        }
+        
+        for (a = L[x]; a; a = a->next) {
+            if ((y = a->target) > x) {
+                v[0] ^= mixKey(z[2 * x] + 3 * z[2 * y]);
+                v[1] ^= mixKey(z[2 * x + 1] + 3 * z[2 * y + 1]);
+            }
+        }
+        
+        if ((rk->keyed[x] = d[x] != 0)) {
+            rk->key   ^= v[0];
+            rk->check ^= v[1];
+        }
+    }
+    
+} /* residualKey */
+
+
+/*! Place anchors from x on, as primeTape does, until a cycle, a dead end
+or a residual graph whose count is already known.  A known count is 
+added to the total and the subtree is skipped, every other anchor opens
+a frame that closeMemoFrames completes. */
+
+static void
+descendWithMemo(HCStateRef s, HCMemo *m, Vertex x)
+{
+    ULongLong   c;
+    HCMemoFrame *f;
+    
+    HCKey      *rk = &m->residual;
+    Arc       **L  = s->adjList;
+    Vertex     *e  = s->virtualEdge;
+    UInt       *d  = s->degree;
+    Vertex     *nv = s->vertexOrder;
+    
+    do {
+        if (lookupMemoTable(m->table, rk->key, rk->check, &c)) {
+            m->cycles += c;
+            return;
+        }
+        
+        /* without room for a frame the subtree is simply not stored */
+        
+        if (m->top < m->size) {
+            f         = m->frame + m->top++;
+            f->depth  = (UInt)(s->pos - s->origin);
+            f->key    = rk->key;
+            f->check  = rk->check;
+            f->cycles = m->cycles;
+        }
+        
+        if (!extendAnchor(s, rk, L, e, d, x)) break;
+        do x = nv[x]; while (!d[x]);
+        
+    } while (true);
+    
+    HC_STAT_DEPTH(s);
+    
+    if (s->flags.isHamiltonCycle) {
+        s->flags.isHamiltonCycle = false;
+        m->cycles++;
+    }
+    
+} /* descendWithMemo */
+
+
+/*! The tape has unwound to anchor hx, every subtree entered at or to 
+the right of it is complete: store its count. */
+
+static inline void
+closeMemoFrames(HCStateRef s, HCMemo *m, HCTape *hx)
+{
+    HCMemoFrame *f;
+    UInt         depth = (UInt)(hx - s->origin);
+    
+    while (m->top && (f = m->frame + m->top - 1)->depth >= depth) {
+        storeMemoTable(m->table, f->key, f->check, m->cycles - f->cycles);
+        m->top--;
+    }
+    
+} /* closeMemoFrames */
+
+
+/*! Run the tape machine over the whole search space, looking up each
+residual graph in a memo table of at most entries keys before searching
+it.  When decide is set the search stops at the first Hamilton cycle:
+every subtree stored before then had no cycle, so the table holds 
+nogoods only.  Returns the cycles found (1 at most when deciding). */
+
+static ULongLong
+memoSearch(HCStateRef s, UInt entries, bool decide)
+{
+    HCMemo          m;
+    MemoStatistics  ms;
+    RandomState     r;
+    HCTape         *hx;
+    Vertex         *d2, x;
+    ULongLong      *z;
+    bool           *keyed;
+    Status          st = STATUS_OK;
+    
+    HCKey          *rk = NULL;         /* set once the key is built */
+    Arc           **L  = s->adjList;
+    Vertex         *e  = s->virtualEdge;
+    UInt           *d  = s->degree;
+    Vertex         *nv = s->vertexOrder;
+    UInt            n  = s->vertexCount;
+    
+    resetStateAndRestoreGraph(s);
+    s->flags.isPrimed = false;
+    s->status         = HC_SEARCH_UNDECIDED;
+    s->cycles         = 0;
+    
+    /* frames open at once are bounded by the anchors of a tape plus 
+       the edges rotated away at them */
+    
+    m.cycles = 0;
+    m.top    = 0;
+    m.size   = 2 * (n + 1);
+    for (x = 1; x <= (Vertex)n; x++) m.size += d[x];
+    
+    /* the vertex values and then the key terms of each vertex */
+    
+    m.table = initMemoTable(allocateMemoTable(entries, &st));
+    EM(z,       4 * (n + 1) * sizeof(ULongLong),  e0);
+    EM(keyed,   (n + 1) * sizeof(bool),            e1);
+    EM(m.frame, m.size * sizeof(HCMemoFrame),      e2);
+    if (!m.table) goto e3;
+    
+    seedRandom(&r, HC_MEMO_SEED);
+    for (x = 0; x < 2 * (n + 1); x++) z[x] = nextRandom(&r);
+    
+    if (forceDegreeTwoVertices(s)) {
+        rk            = &m.residual;
+        rk->zobrist   = z;
+        rk->vertexKey = z + 2 * (n + 1);
+        rk->keyed     = keyed;
+        residualKey(s, rk);
+        
+        x = 0;
+        do x = nv[x]; while (!d[x]);
+        descendWithMemo(s, &m, x);
+    } else if (s->flags.isHamiltonCycle) {
+        s->flags.isHamiltonCycle = false;
+        m.cycles++;
+    }
+    
+    if (decide && m.cycles) goto found;
+    
+    hx = unwindSearchEdge(s, rk, L, e, d, s->pos);
+    closeMemoFrames(s, &m, hx);
+    
+    while (!(hx->status & HC_TERMINATE)) {
+    
+        if (searchInterrupted(s)) {
+            s->pos = hx;
+            goto done;
+        }
+        
+        s->rotations++;
+        
+        x = rotateAnchorPoint(s, rk, L, e, d, hx, &d2);
+        x = ensureConsistent(s, rk, L, e, d, d2, x, nv);
+        
+        if (x) descendWithMemo(s, &m, x);
+        else if (s->flags.isHamiltonCycle) {
+            s->flags.isHamiltonCycle = false;
+            m.cycles++;
+        }
+        
+        if (decide && m.cycles) goto found;
+        
+        hx = unwindSearchEdge(s, rk, L, e, d, s->pos);
+        closeMemoFrames(s, &m, hx);
+    }
+    
+    s->pos    = hx;
+    s->status = HC_SEARCH_EXHAUSTED;
+    goto done;
+    
+found:
+    s->status                = HC_SEARCH_CYCLE;
+    s->flags.isHamiltonian   = true;
+    s->flags.isHamiltonCycle = true;
+    
+done:
+    getMemoStatistics(m.table, &ms);
+    s->stats.memoHits      += ms.hits;
+    s->stats.memoMisses    += ms.misses;
+    s->stats.memoEvictions += ms.evictions;
+    s->cycles               = m.cycles;
+    
+    /* a cycle found is left on the tape for getCurrentHamiltonianCycle */
+    
+    if (s->status != HC_SEARCH_CYCLE) resetStateAndRestoreGraph(s);
+    
+e3: free(m.frame);
+e2: free(keyed);
+e1: free(z);
+e0: releaseMemoTable(m.table);
+    return m.cycles;
+    
+} /* memoSearch */
+
+
+/*! Count the Hamilton cycles of the graph, memoizing the counts of 
+residual graphs in a table of at most entries keys so that a residual
+graph reached again through a different tape prefix is not searched 
+again.  The count is exact when getHCSearchStatus then reports 
+HC_SEARCH_EXHAUSTED, a lower bound when a search limit stopped it 
+(HC_SEARCH_UNDECIDED).  A stopped count cannot be resumed, the state 
+is left as after initHCState. */
+
+ULongLong
+countHamiltonianCycles(HCStateRef s, UInt entries)
+{
+    return memoSearch(s, entries, false);
+} /* countHamiltonianCycles */
+
+
+/*! The run of cycles a tape position has held the edge of an arc. */
+
+typedef struct hc_edge_run {
+    Arc       *arc;
+    Arc       *cross;
+    UInt       edge;
+    ULongLong  since;      /* first cycle of the run */
+} HCEdgeRun;
+
+/*! Slot of an arc in an open addressing table of mask + 1 entries. */
+
+typedef struct hc_arc_slot {
+    Arc     *arc;
+    UInt     edge;
+} HCArcSlot;
+
+static inline UInt
+arcSlot(Arc *a, UInt mask)
+{
+    return (UInt)(((ULongLong)(size_t)a >> 4) * 0x9E3779B97F4A7C15ULL >> 32) 
+           & mask;
+} /* arcSlot */
+
+
+/*! Count the Hamilton cycles through each of the m edges listed by
+listEdges for the graph given to initHCState, through[i] receiving the
+count of edge i.  A tape position is credited to the edge of its arc for
+the run of cycles it held that edge.  A cycle differs from the one before
+it only right of the lowest anchor rotated in between, so only those 
+positions are visited per cycle; the edge of a new arc is found in a 
+table keyed by the arc.  Returns the number of cycles; when a search 
+limit stops the enumeration (HC_SEARCH_UNDECIDED) the counts are those 
+of the cycles found. */
+
+ULongLong
+countHamiltonianCyclesPerEdge(HCStateRef s, bool prune, Vertex *edges, 
+                              UInt m, ULongLong *through)
+{
+    HCTape     *tp;
+    HCArcSlot  *t;
+    Arc        *a;
+    HCEdgeRun  *run;
+    Vertex      x;
+    UInt        i, j, mask;
+    ULongLong   k = 0;
+    bool        found;
+    
+    UInt        n   = s->vertexCount;
+    HCTape     *end = s->origin + n;
+    
+    memset(through, 0, m * sizeof(ULongLong));
+    
+    for (mask = 1; mask < 4 * m; mask <<= 1);
+    
+    EM(t,   mask * sizeof(HCArcSlot), e0);
+    EM(run, (n + 1) * sizeof(HCEdgeRun),   e1);
+    memset(t,   0, mask * sizeof(HCArcSlot));
+    memset(run, 0, (n + 1) * sizeof(HCEdgeRun));
+    mask--;
+    
+    /* both arcs of every edge, read from the lists before the search */
+    
+    resetStateAndRestoreGraph(s);
+    for (x = 1; x <= (Vertex)n; x++) {
+        for (a = s->adjList[x]; a; a = a->next) {
+            for (j = arcSlot(a, mask); t[j].arc; j = (j + 1) & mask);
+            t[j].arc  = a;
+            t[j].edge = edgeIndex(edges, m, x, a->target);
+        }
+    }
+    
+    found = prune ? firstHamiltonianCycleWithPruning(s)
+                  : firstHamiltonianCycle(s);
+    s->lowest = s->origin + 1;
+    
+    while (found) {
+        k++;
+        
+        /* a position rewritten with the same edge keeps its run */
+        
+        for (tp = s->lowest; tp <= end; tp++) {
+            i = tp - s->origin;
+            a = tp->arc;
+            if (a == run[i].arc || a == run[i].cross) continue;
+            
+            if (run[i].arc) through[run[i].edge] += k - run[i].since;
+            for (j = arcSlot(a, mask); t[j].arc != a; j = (j + 1) & mask);
+            run[i].arc   = a;
+            run[i].cross = a->cross;
+            run[i].edge  = t[j].edge;
+            run[i].since = k;
+        }
+        s->lowest = end + 1;
+        
+        found = prune ? nextHamiltonianCycleWithPruning(s)
+                      : nextHamiltonianCycle(s);
+    }
+    
+    /* credit the runs still open at the last cycle */
+    
+    for (i = 1; k && i <= n; i++) 
+        through[run[i].edge] += k + 1 - run[i].since;
+    
+    free(run);
+    free(t);
+    return k;
+    
+e1: free(t);
+e0: s->status = HC_SEARCH_UNDECIDED;
+    return 0;
+    
+} /* countHamiltonianCyclesPerEdge */
+
+
+/*! Decide if the graph is Hamiltonian, remembering the residual graphs
+of failed subtrees as nogoods in a table of at most entries keys.  A 
+dead end reached again through other anchors and removed edges is then
+skipped instead of searched.  A cycle found can be read with
+getCurrentHamiltonianCycle, the search cannot be continued with the
+next calls. */
+
+bool
+firstHamiltonianCycleWithNogoods(HCStateRef s, UInt entries)
+{
+    return memoSearch(s, entries, true) != 0;
+} /* firstHamiltonianCycleWithNogoods */
+
+
+
+HCStateRef
+allocateHCState(UInt points, StatusRef status)
+{
+    HCStateRef s;
+    UInt       n = 1 + points;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+
+    EM(s,                     sizeof(struct hc_state),           e0);
+    EM(s->virtualEdge,        n * sizeof(Vertex),              e1);
+    EM(s->deg2Stack,          n * sizeof(Vertex),              e2);
+    EM(s->removedEdgesStack,  n * sizeof(void *),              e3);
+    EM(s->pos,                (points + 2) * sizeof(HCTape),     e4);
+    EM(s->vertexOrder,        n * sizeof(Vertex),              e5);
+    EM(s->branch,             (points + 2) * sizeof(UInt),       e6);
+    
+#ifdef HC_TRACE
+    EM(s->trace,              HC_TRACE_EVENTS * sizeof(HCTraceEvent), e7);
+#endif
+    
+    s->dfs         = allocateDFS(points);
+    s->vertexCount = points;
+    
+    if (!s->dfs) goto e8;
+
+    return s;
+
+e8:
+#ifdef HC_TRACE
+    free(s->trace);
+e7:
+#endif
+    free(s->branch);
+e6: free(s->vertexOrder);
+e5: free(s->pos);
+e4: free(s->removedEdgesStack);
+e3: free(s->deg2Stack);
+e2: free(s->virtualEdge);
+e1:    free(s);
+    
+e0:    *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocHCState */
+
+
+HCStateRef
+initHCState(HCStateRef s, UInt *d, Arc **adj, VArray *vo)
+{
+
+    s->adjList            = adj;
     s->degree             = d;
     s->origin             = s->pos;
     *s->deg2Stack         = 0;
     s->removedEdges       = NULL;
     *s->removedEdgesStack = NULL;
+    s->label              = NULL;
+    s->required           = NULL;
+    s->requiredCount      = 0;
+    s->forbidden          = NULL;
+    s->forbiddenCount     = 0;
+    s->status             = HC_SEARCH_EXHAUSTED;
+    s->rotations          = 0;
+    s->rotationLimit      = ULongLong_MAX;
+    s->checkpoint         = ULongLong_MAX;
+    s->deadline           = 0;
+    s->clockCheck         = 0;
+    s->flags.isPrimed     = false;
+    s->flags.tracksProgress = false;
+    s->cycles             = 0;
+    s->lowest             = s->origin;
+    s->branchTop          = s->branch;
+    
+    memset(s->branch, 0, (s->vertexCount + 2) * sizeof(UInt));
+    
+    memset(&s->stats, 0, sizeof(HCStatistics));
+#ifdef HC_STATISTICS
+    s->stats.enabled = true;
+#endif
+#ifdef HC_TRACE
+    atomic_store(&s->traceHead, 0);
+    s->traceStart = monotonicSeconds();
+#endif
+    
+    atomic_store(&s->cancelled, false);
     
     s->pos[s->vertexCount+1].status = HC_HAMILTONIAN;
     s->pos->status                  = HC_TERMINATE;
     
-    /* set up vertex order */
-    
-    nv  = s->vertexOrder;
-    vl  = vo->array;
-    *nv = *vo->array;
-    for (x = 1 ; x < (Vertex)s->vertexCount ; x++) nv[vl[x-1]] = vl[x];
-    
-    /* mark the end of the list, allows for a vertex remaining count */
-    nv[ vl[x-1] ] = 0;        
+    setVertexOrder(s, vo);
     
     return s;
 } /* initHCState */
 
 
+/*! Ask a search running on another thread to stop.  The search returns
+false at its next anchor rotation and getHCSearchStatus reports 
+HC_SEARCH_UNDECIDED. The request stays in effect until the state is 
+initialized again or new limits are set. */
+
+void
+cancelHamiltonianCycleSearch(HCStateRef s)
+{
+    atomic_store(&s->cancelled, true);
+} /* cancelHamiltonianCycleSearch */
+
+
+/*! Undo what the last search did to the adjacency lists and degrees the
+state was initialized with and rewind its tape, so that the graph can be
+changed and the state initialized again.  The current cycle is lost. */
+
+void
+resetHCState(HCStateRef s)
+{
+    resetStateAndRestoreGraph(s);
+} /* resetHCState */
+
+
+/*! Limit the search to at most rotations more anchor rotations and 
+seconds more of wall time, a value of 0 removes the respective limit. 
+The limits apply to every search call made on the state until they are 
+set again. A pending cancel request is withdrawn.
+
+A search that hits a limit, or is cancelled, returns false with 
+getHCSearchStatus reporting HC_SEARCH_UNDECIDED.  The state is left at
+an anchor point, calling the next function matching the interrupted 
+search (nextHamiltonianCycle or nextHamiltonianCycleWithPruning) after
+setting new limits continues the search exactly where it stopped. */
+
+void
+setHCSearchLimits(HCStateRef s, ULongLong rotations, double seconds)
+{
+    s->rotationLimit = rotations && rotations < ULongLong_MAX - s->rotations 
+                        ? s->rotations + rotations : ULongLong_MAX;
+    s->deadline      = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    s->clockCheck    = s->rotations + HC_CLOCK_INTERVAL;
+    
+    setCheckpoint(s);
+    atomic_store(&s->cancelled, false);
+    
+} /* setHCSearchLimits */
+
+
+/*! Run the search for at most rotations more anchor rotations, 0 for no
+step bound, and report where it stands: HC_SEARCH_CYCLE when a Hamilton
+cycle is found (read it with getCurrentHamiltonianCycle before the next
+step), HC_SEARCH_EXHAUSTED once no further cycles exist, and 
+HC_SEARCH_UNDECIDED when the step ended first and more steps are needed.
+
+The first step after initHCState starts the search, later steps continue
+it, so a caller can interleave many searches on a few threads by 
+stepping each state in turn. The limits of setHCSearchLimits still 
+apply, cancellation also ends a step as HC_SEARCH_UNDECIDED.  All steps 
+on a state must use the same prune setting. */
+
+HCSearchStatus
+stepHamiltonianCycle(HCStateRef s, ULongLong rotations, bool prune)
+{
+    ULongLong limit = s->rotationLimit;
+    
+    if (s->flags.isPrimed && s->status == HC_SEARCH_EXHAUSTED) 
+        return HC_SEARCH_EXHAUSTED;
+    
+    if (rotations && rotations < limit - s->rotations) {
+        s->rotationLimit = s->rotations + rotations;
+        setCheckpoint(s);
+    }
+    
+    if (!s->flags.isPrimed)
+        prune ? firstHamiltonianCycleWithPruning(s) 
+              : firstHamiltonianCycle(s);
+    else 
+        prune ? nextHamiltonianCycleWithPruning(s) 
+              : nextHamiltonianCycle(s);
+    
+    s->rotationLimit = limit;
+    setCheckpoint(s);
+    
+    return s->status;
+    
+} /* stepHamiltonianCycle */
+
+
+/*! Anchor rotations made by all searches on the state so far. */
+
+ULongLong
+getHCRotationCount(HCStateRef s)
+{
+    return s->rotations;
+} /* getHCRotationCount */
+
+
+/*! Copy the search statistics gathered since initHCState into st. Only
+rotations is counted in every build, the other counters stay 0 unless 
+the library is compiled with HC_STATISTICS defined (st->enabled tells 
+which). */
+
+void
+getHCStatistics(HCStateRef s, HCStatistics *st)
+{
+    *st           = s->stats;
+    st->rotations = s->rotations;
+} /* getHCStatistics */
+
+
+/*! Copy up to max of the most recent trace events into ev, oldest
+first, and return how many were copied.  May be called from another 
+thread while the search runs: events overwritten during the copy are 
+dropped.  Always returns 0 unless the library is compiled with HC_TRACE 
+defined. */
+
+UInt
+getHCTrace(HCStateRef s, HCTraceEvent *ev, UInt max)
+{
+#ifdef HC_TRACE
+    ULongLong  head, first, tail;
+    UInt       i, n;
+    
+    head  = atomic_load_explicit(&s->traceHead, memory_order_acquire);
+    first = head > HC_TRACE_EVENTS ? head - HC_TRACE_EVENTS : 0;
+    if (head - first > max) first = head - max;
+    
+    for (i = 0; first + i < head; i++)
+        ev[i] = s->trace[(first + i) & (HC_TRACE_EVENTS - 1)];
+    
+    /* the writer may have lapped the oldest entries while copying, and
+       may be filling the slot of event tail right now */
+    
+    tail = atomic_load_explicit(&s->traceHead, memory_order_acquire);
+    n    = i;
+    if (tail + 1 > first + HC_TRACE_EVENTS) {
+        i = (UInt)(tail + 1 - HC_TRACE_EVENTS - first);
+        if (i >= n) return 0;
+        memmove(ev, ev + i, (n - i) * sizeof(HCTraceEvent));
+        n -= i;
+    }
+    return n;
+#else
+    return 0;
+#endif
+} /* getHCTrace */
+
+
+/*! Write the trace of s as text, a header line and one 
+"time type depth vertex" line per event, type being one of the letters
+A (anchor), E (extend), F (forced), P (prune) and U (unwind). */
+
+void
+writeHCTrace(HCStateRef s, FILE *f)
+{
+#ifdef HC_TRACE
+    HCTraceEvent *ev;
+    UInt          i, n;
+    
+    static const char type[] = "AEFPU";
+    
+    if (!(ev = malloc(HC_TRACE_EVENTS * sizeof(HCTraceEvent)))) return;
+    
+    n = getHCTrace(s, ev, HC_TRACE_EVENTS);
+    fprintf(f, "# hc trace, %u events\n", n);
+    for (i = 0; i < n; i++)
+        fprintf(f, "%.9f %c %u %u\n", ev[i].time, type[ev[i].type], 
+                ev[i].depth, ev[i].vertex);
+    
+    free(ev);
+#else
+    fprintf(f, "# hc trace, 0 events (built without HC_TRACE)\n");
+#endif
+} /* writeHCTrace */
+
+
+/*! Estimate how much of the search space has been covered.
+
+Every tape position from the origin up to the head that is an anchor, or
+has been rotated, is a branch point of the search tree.  Its done
+branches are the rotations made there, its untried ones are the arcs 
+following the current one in an anchor's list (one, dropping the edge,
+for an anchor that is not extended).  Taking the branches of a point to
+be of equal size gives
+
+    fraction = sum_i done_i / total_i * prod_{j<i} 1 / total_j.
+
+This is exact for a balanced search tree, in general it is a rough 
+guide. Only meaningful between search calls, and the done branches are
+counted only while trackHCProgress is on. */
+
+void
+getHCProgress(HCStateRef s, HCProgress *p)
+{
+    HCTape  *hx;
+    Arc     *a;
+    UInt     done, left;
+    
+    double   share    = 1.0;
+    double   fraction = 0.0;
+    UInt    *b        = s->branch;
+    Arc    **L        = s->adjList;
+    
+    p->cycles    = s->cycles;
+    p->rotations = s->rotations;
+    
+    if (!s->flags.isPrimed) {
+        p->fraction = 0.0;
+        return;
+    }
+    
+    if (s->status == HC_SEARCH_EXHAUSTED) {
+        p->fraction = 1.0;
+        return;
+    }
+    
+    for (hx = s->origin + 1; hx <= s->pos && share > 1e-15; hx++) {
+    
+        done = b[hx - s->origin];
+        left = 0;
+        
+        if (hx->status & HC_ANCHOR_EXTEND) {
+        
+            /* the current arc is first in the list of the anchor */
+            
+            for (a = L[hx->arc->target]; a; a = a->next) left++;
+            if (left) left--;
+            
+        } else if ((hx->status & (HC_ANCHOR_POINT | HC_TERMINATE)) == 
+                   HC_ANCHOR_POINT) left = 1;
+        
+        if (!done && !left) continue;
+        
+        share    /= done + 1 + left;
+        fraction += share * done;
+    }
+    
+    p->fraction = fraction < 1.0 ? fraction : 1.0;
+    
+} /* getHCProgress */
+
+
+/*! Keep the rotations made at each tape position for getHCProgress.  Off
+after initHCState, as the count costs a few stores per rotation; turn it
+on before the first call of the search to be reported on. */
+
+void
+trackHCProgress(HCStateRef s, bool track)
+{
+    s->flags.tracksProgress = track;
+} /* trackHCProgress */
+
+
+/*! Outcome of the last first/next call made on the state. */
+
+HCSearchStatus
+getHCSearchStatus(HCStateRef s)
+{
+    return s->status;
+} /* getHCSearchStatus */
+
+
+/*! Report cycles in terms of labels->array, where vertex x of the graph
+the state was initialized with is reported as labels->array[x-1].  Used
+when the graph searched is a relabeled copy (see relabelGraph). A NULL
+labels restores the identity. */
+
+void
+setHCStateLabels(HCStateRef s, VArray *labels)
+{
+    s->label = labels ? labels->array : NULL;
+} /* setHCStateLabels */
+
+
+/*! Restrict the searches of the state to the Hamilton cycles that use 
+every edge of required and none of forbidden.  Both are arrays of 
+vertex pairs x,y (2 * count entries) that must stay valid while the 
+state is searched, they are applied each time a search starts so the 
+graph is never edited.  Counts of 0 remove the constraints, as does 
+initHCState. */
+
+void
+setHCEdgeConstraints(HCStateRef s, Vertex *required, UInt nrequired,
+                     Vertex *forbidden, UInt nforbidden)
+{
+    s->required       = required;
+    s->requiredCount  = nrequired;
+    s->forbidden      = forbidden;
+    s->forbiddenCount = nforbidden;
+} /* setHCEdgeConstraints */
+
+
 void
 releaseHCState(HCStateRef s)
 {
@@ -1157,6 +2737,10 @@ releaseHCState(HCStateRef s)
     restoreGraph(s);
     releaseDFS(s->dfs);
     
+#ifdef HC_TRACE
+    free(s->trace);
+#endif
+    free(s->branch);
     free(s->vertexOrder);
     free(s->origin);
     free(s->removedEdgesStack);
@@ -1176,12 +2760,18 @@ getCurrentHamiltonianCycle(HCStateRef s, Vertex *v )
     HCTape *tp  = s->origin + 1;
     UInt    pts = s->vertexCount;
     Vertex *vn  = v + pts;
+    Vertex *lb  = s->label;
     Vertex  x, y;
 
     while (pts--) {
         x = tp->arc->target;
         y = tp->arc->cross->target;
         
+        if (lb) {
+            x = lb[x-1];
+            y = lb[y-1];
+        }
+        
         if (v[x]) vn[x] = y;
         else v[x] = y;
         
@@ -1200,10 +2790,17 @@ getCurrentHamiltonianCycleEdges(HCStateRef s, Vertex *e)
 {
     Vertex *ep = e + 2 * s->vertexCount;
     HCTape *tp = s->origin + 1;
+    Vertex *lb = s->label;
     
     while (ep != e){
         *(--ep) = tp->arc->target;
         *(--ep) = tp->arc->cross->target;
+        
+        if (lb) {
+            ep[0] = lb[ep[0]-1];
+            ep[1] = lb[ep[1]-1];
+        }
+        
         tp++;
     }    
 }
@@ -20,19 +20,132 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifndef HAMILTONIANCYCLE_H
 #define HAMILTONIANCYCLE_H
 
+#include <stdio.h>
 #include "Arch.h"
 #include "Graph.h"
 
 typedef struct hc_state * HCStateRef; /* opaque type */
 
+/*! Outcome of a search call.  A false return from the first/next calls
+    means HC_SEARCH_EXHAUSTED unless the search was stopped early. */
+
+typedef enum hc_search_status {
+    HC_SEARCH_EXHAUSTED = 0,  /*!< no (further) Hamilton cycles exist    */
+    HC_SEARCH_CYCLE     = 1,  /*!< a Hamilton cycle has been found       */
+    HC_SEARCH_UNDECIDED = 2   /*!< search stopped before an answer found */
+} HCSearchStatus;
+
+/*! Work done by the searches on a state, see getHCStatistics. */
+
+typedef struct hc_statistics {
+    bool      enabled;     /*!< built with HC_STATISTICS                 */
+    ULongLong rotations;   /*!< anchor rotations (rotateAnchorPoint)     */
+    ULongLong anchors;     /*!< anchors placed (extendAnchor)            */
+    ULongLong extensions;  /*!< segment extension passes (extendSegments)*/
+    ULongLong unwinds;     /*!< tape unwinds to an anchor                */
+    ULongLong prunes;      /*!< branches cut by pruneSearchSpace         */
+    ULongLong forced;      /*!< vertices absorbed by segments, HC_FORCED */
+    ULongLong forcedDeg2;  /*!< of those, had in arcs cut, FORCED_DEG2   */
+    ULongLong memoHits;    /*!< residual graphs found in the memo table  */
+    ULongLong memoMisses;  /*!< residual graphs searched by the count    */
+    ULongLong memoEvictions; /*!< memo entries dropped to make room     */
+    UInt      maxDepth;    /*!< deepest tape position reached            */
+} HCStatistics;
+
+/*! Progress of a running enumeration, see getHCProgress. */
+
+typedef struct hc_progress {
+    double    fraction;    /*!< estimated share of search space covered */
+    ULongLong cycles;      /*!< cycles found since the last first call   */
+    ULongLong rotations;   /*!< anchor rotations made so far             */
+} HCProgress;
+
+/*! Monte Carlo estimate, see estimateHamiltonianCycles.  The errors are
+    half widths of 95% confidence intervals. */
+
+typedef struct hc_estimate {
+    ULongLong probes;      /*!< random probes made                       */
+    double    nodes;       /*!< estimated search tree branch points      */
+    double    nodesError;
+    double    cycles;      /*!< estimated number of Hamilton cycles      */
+    double    cyclesError;
+} HCEstimate;
+
+/*! Kinds of events recorded by the trace of a state, see getHCTrace. */
+
+typedef enum hc_trace_type {
+    HC_TRACE_ANCHOR = 0,   /*!< anchor placed on vertex                */
+    HC_TRACE_EXTEND = 1,   /*!< segment extended from vertex           */
+    HC_TRACE_FORCED = 2,   /*!< degree 2 vertex forced, in arcs cut    */
+    HC_TRACE_PRUNE  = 3,   /*!< branch cut by pruneSearchSpace         */
+    HC_TRACE_UNWIND = 4    /*!< tape unwound to depth                  */
+} HCTraceType;
+
+/*! One traced event, time is in seconds since initHCState and depth is
+    the tape position relative to the origin. */
+
+typedef struct hc_trace_event {
+    double      time;
+    HCTraceType type;
+    UInt        depth;
+    Vertex      vertex;
+} HCTraceEvent;
+
 HCStateRef allocateHCState(UInt pts, Status *status);
 HCStateRef initHCState(HCStateRef s, UInt *d, Arc **adj, VArray *vo);
                         
+void setHCStateLabels(HCStateRef s, VArray *labels);
+
+/* cycles must use the required and avoid the forbidden edges, given as
+   x,y vertex pairs */
+void setHCEdgeConstraints(HCStateRef s, Vertex *required, UInt nrequired,
+                          Vertex *forbidden, UInt nforbidden);
+                        
 void releaseHCState(HCStateRef s);
 bool firstHamiltonianCycle(HCStateRef s);
 bool nextHamiltonianCycle(HCStateRef s);
 bool firstHamiltonianCycleWithPruning(HCStateRef s);
 bool nextHamiltonianCycleWithPruning(HCStateRef s);
+bool firstHamiltonianCycleWithRestarts(HCStateRef s, ULongLong seed,
+                        ULongLong unit, UInt restarts, bool prune);
+
+/* limits and cancellation, an interrupted search returns false with
+   status HC_SEARCH_UNDECIDED and is resumed by the matching next call */
+void setHCSearchLimits(HCStateRef s, ULongLong rotations, double seconds);
+void cancelHamiltonianCycleSearch(HCStateRef s);
+
+/* restore the graph given to initHCState after a search, in particular 
+   one that found a cycle or was stopped, before changing it */
+void resetHCState(HCStateRef s);
+HCSearchStatus getHCSearchStatus(HCStateRef s);
+ULongLong getHCRotationCount(HCStateRef s);
+void getHCStatistics(HCStateRef s, HCStatistics *st);
+void getHCProgress(HCStateRef s, HCProgress *p);
+void trackHCProgress(HCStateRef s, bool track);
+
+/* events kept by the trace ring buffer, empty unless the library is
+   compiled with HC_TRACE defined */
+UInt getHCTrace(HCStateRef s, HCTraceEvent *ev, UInt max);
+void writeHCTrace(HCStateRef s, FILE *f);
+
+/* random probe estimate of search tree size and cycle count */
+void estimateHamiltonianCycles(HCStateRef s, ULongLong probes, 
+                        ULongLong seed, HCEstimate *est);
+
+/* exhaustive count memoizing the counts of residual graphs in a table
+   of at most entries keys */
+ULongLong countHamiltonianCycles(HCStateRef s, UInt entries);
+
+/* count of the cycles through each edge, edges as from listEdges */
+ULongLong countHamiltonianCyclesPerEdge(HCStateRef s, bool prune, 
+                        Vertex *edges, UInt m, ULongLong *through);
+
+/* decision remembering failed residual graphs as nogoods */
+bool firstHamiltonianCycleWithNogoods(HCStateRef s, UInt entries);
+
+/* time sliced search, runs at most rotations anchor rotations per call */
+HCSearchStatus stepHamiltonianCycle(HCStateRef s, ULongLong rotations, 
+                        bool prune);
 
 /* v is a 2n+1 sized array initialized to 0's
    returns cycle ptrs where v[x] and v[n+x] point to adjacent vertices
@@ -0,0 +1,256 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "HamiltonianPath.h"
+
+/* NOTES:
+
+A Hamilton path of G from s to t is a Hamilton cycle of G + z, where the
+extra vertex z is joined to s and t only; with a free end z is joined 
+to every vertex, and with one end s fixed the edge zs is required (see
+setHCEdgeConstraints).  Each path is the cycle read from z, so paths 
+are found and counted once each by the cycle engine.
+
+The graph is not copied.  The path state keeps its own array of list 
+heads, with z as vertex n + 1, over the caller's arcs, and the arcs of 
+z are linked into the lists of their ends.  resetHCPath unlinks them 
+and hands the list heads, which the search may have reordered, back to
+the caller. */
+
+struct hc_path {
+    HCStateRef  hc;
+    UInt        pts;
+    Arc       **adj;        /* caller's lists while in use, else NULL */
+    Arc       **L;          /* heads of the lists of G + z */
+    UInt       *d;
+    Arc        *arcs;       /* the two arcs of each edge at z */
+    UInt        links;      /* edges at z */
+    VArray     *order;
+    Vertex     *cycle;      /* 2(n+1)+1 entries */
+    Vertex      source;
+    Vertex      zs[2];      /* the required edge zs */
+};
+
+
+HCPathRef
+allocateHCPath(UInt pts, Status *status)
+{
+    HCPathRef p;
+    UInt      n = pts + 1;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    EM(p,         sizeof(struct hc_path),          e0);
+    EM(p->L,      (n + 1) * sizeof(Arc *),         e1);
+    EM(p->d,      (n + 1) * sizeof(UInt),          e2);
+    EM(p->arcs,   2 * pts * sizeof(Arc),           e3);
+    EM(p->cycle,  (2 * n + 1) * sizeof(Vertex),    e4);
+    
+    p->pts   = pts;
+    p->adj   = NULL;
+    p->links = 0;
+    p->hc    = allocateHCState(n, status);
+    p->order = allocateVArray(n, status);
+    
+    if (*status == STATUS_OK) {
+    
+        /* a state released without a search still needs a valid tape */
+        
+        memset(p->L, 0, (n + 1) * sizeof(Arc *));
+        memset(p->d, 0, (n + 1) * sizeof(UInt));
+        initHCState(p->hc, p->d, p->L, initVArray(p->order));
+        return p;
+    }
+    
+    if (p->order) releaseVArray(p->order);
+    if (p->hc) releaseHCState(p->hc);
+    free(p->cycle);
+    
+e4: free(p->arcs);
+e3: free(p->d);
+e2: free(p->L);
+e1: free(p);
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocateHCPath */
+
+
+/*! Join z to x by the next pair of arcs. */
+
+static void
+linkEndpoint(HCPathRef p, Vertex x)
+{
+    Vertex   z = p->pts + 1;
+    Arc     *a = p->arcs + 2 * p->links++;
+    Arc     *c = a + 1;
+    
+    a->target = x;
+    a->cross  = c;
+    c->target = z;
+    c->cross  = a;
+    
+    insertArc(p->L + z, a);
+    insertArc(p->L + x, c);
+    p->d[z]++;
+    p->d[x]++;
+    
+} /* linkEndpoint */
+
+
+HCPathRef
+initHCPath(HCPathRef p, UInt *d, Arc **adj, Vertex source, Vertex target)
+{
+    Vertex   x;
+    
+    UInt     pts = p->pts;
+    Vertex   z   = pts + 1;
+    
+    resetHCPath(p);
+    
+    if (!source) {
+        source = target;
+        target = 0;
+    }
+    
+    memcpy(p->L, adj, (pts + 1) * sizeof(Arc *));
+    memcpy(p->d, d,   (pts + 1) * sizeof(UInt));
+    p->L[z]   = NULL;
+    p->d[z]   = 0;
+    p->adj    = adj;
+    p->source = source;
+    
+    if (target && source != target) {
+        linkEndpoint(p, source);
+        linkEndpoint(p, target);
+    } else if (target || pts < 2) {
+    
+        /* z has degree 1, no cycle */
+        
+        linkEndpoint(p, source ? source : 1);
+    } else {
+        for (x = 1; x <= (Vertex)pts; x++) linkEndpoint(p, x);
+    }
+    
+    sortVerticesDegreeDesc(initVArray(p->order), p->d);
+    initHCState(p->hc, p->d, p->L, p->order);
+    
+    if (source && !target) {
+        p->zs[0] = z;
+        p->zs[1] = source;
+        setHCEdgeConstraints(p->hc, p->zs, 1, NULL, 0);
+    }
+    
+    return p;
+    
+} /* initHCPath */
+
+
+/*! Restore the lists and give them back to the caller of initHCPath. */
+
+void
+resetHCPath(HCPathRef p)
+{
+    Arc     *a;
+    
+    if (!p->adj) return;
+    
+    resetHCState(p->hc);
+    
+    for (a = p->arcs + 2 * p->links; a > p->arcs; a -= 2) 
+        removeArc(p->L + a[-2].target, a - 1);
+    
+    memcpy(p->adj, p->L, (p->pts + 1) * sizeof(Arc *));
+    p->adj   = NULL;
+    p->links = 0;
+    
+} /* resetHCPath */
+
+
+void
+releaseHCPath(HCPathRef p)
+{
+    resetHCPath(p);
+    releaseVArray(p->order);
+    releaseHCState(p->hc);
+    free(p->cycle);
+    free(p->arcs);
+    free(p->d);
+    free(p->L);
+    free(p);
+} /* releaseHCPath */
+
+
+bool
+firstHamiltonianPath(HCPathRef p, bool prune)
+{
+    return prune ? firstHamiltonianCycleWithPruning(p->hc)
+                 : firstHamiltonianCycle(p->hc);
+} /* firstHamiltonianPath */
+
+
+bool
+nextHamiltonianPath(HCPathRef p, bool prune)
+{
+    return prune ? nextHamiltonianCycleWithPruning(p->hc)
+                 : nextHamiltonianCycle(p->hc);
+} /* nextHamiltonianPath */
+
+
+/*! The cycle of G + z read from z, towards the source when it is fixed. */
+
+void
+getCurrentHamiltonianPath(HCPathRef p, Vertex *path)
+{
+    Vertex   x, y, w;
+    UInt     i;
+    
+    UInt     n = p->pts + 1;
+    Vertex  *c = p->cycle;
+    
+    memset(c, 0, (2 * n + 1) * sizeof(Vertex));
+    getCurrentHamiltonianCycle(p->hc, c);
+    
+    w = n;
+    x = p->source ? p->source : c[n];
+    
+    for (i = 0; i < p->pts; i++) {
+        path[i] = x;
+        y = c[x] != w ? c[x] : c[n + x];
+        w = x;
+        x = y;
+    }
+    
+} /* getCurrentHamiltonianPath */
+
+
+HCStateRef
+getHCPathState(HCPathRef p)
+{
+    return p->hc;
+} /* getHCPathState */
@@ -0,0 +1,51 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef HAMILTONIANPATH_H
+#define HAMILTONIANPATH_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+typedef struct hc_path * HCPathRef;  /* opaque type */
+
+HCPathRef allocateHCPath(UInt pts, Status *status);
+
+/* search the Hamilton paths of the graph given by d and adj from source 
+   to target, 0 leaving that end free.  The lists are in use by the path
+   state until resetHCPath or releaseHCPath gives them back. */
+HCPathRef initHCPath(HCPathRef p, UInt *d, Arc **adj, Vertex source, 
+                     Vertex target);
+void resetHCPath(HCPathRef p);
+void releaseHCPath(HCPathRef p);
+
+bool firstHamiltonianPath(HCPathRef p, bool prune);
+bool nextHamiltonianPath(HCPathRef p, bool prune);
+
+/* path (n entries) receives the vertices of the current path in order, 
+   starting at the source when it is fixed */
+void getCurrentHamiltonianPath(HCPathRef p, Vertex *path);
+
+/* the cycle state searched, for its limits, status and statistics */
+HCStateRef getHCPathState(HCPathRef p);
+
+#endif /* HAMILTONIANPATH_H */
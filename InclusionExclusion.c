@@ -0,0 +1,351 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "Timer.h"
+#include "BitSet.h"
+#include "TapeBudget.h"
+#include "InclusionExclusion.h"
+
+/* NOTES:
+
+A closed walk of n steps from a vertex s that visits every vertex is a
+Hamilton cycle walked in one of two directions.  The walks inside a
+subset T containing s number W(T) = (A_T^n)[s][s], and by inclusion and
+exclusion over the vertices X = V - T a walk misses
+
+    2 c = sum over X in V - s of (-1)^|X| W(V - X)
+
+so c is found in space polynomial in n.  Adjacency is symmetric, so with
+v = A_T^h e_s, h = n / 2, W(T) is v.v for even n and v.(A_T v) for odd n
+and only h products are made.  The products are sums of counts, all 
+taken modulo 2^128 (UHugeInt_BIT) with the unsigned wrap, so the sum is
+2 c itself only when 2 c is below 2^128.  2 c is at most the product of
+the degrees and at most (n - 1)!, and graphs where that bound reaches 
+2^128 are refused, it never does up to 35 vertices.  When the bound is 
+below 2^64 the sum is taken modulo 2^64 instead, about a third faster.
+
+The sets X are met in Gray code order, X and the next set differ in one
+vertex x.  The walks of two steps, v_2(u) = |N(u) & N(s) & T|, change 
+by one at the neighbours of x when x is next to s, so they are updated
+in place and only the steps from 3 to h are multiplied out.  Workers 
+take chunks of 2^HC_INCLUSION_CHUNK consecutive Gray code ranks, a 
+chunk starting from the set of its first rank. */
+
+/* Gray code ranks per chunk handed to a worker */
+
+#define HC_INCLUSION_CHUNK 12
+
+/* one tape rotation costs about as much as this many arcs followed by 
+   the sum */
+
+#define HC_INCLUSION_ROTATION_ARCS 256
+
+typedef struct hc_inclusion {
+    UInt            pts;
+    BitSet       adj[HC_INCLUSION_MAX_VERTICES];
+    UInt            start;
+    UInt            other[HC_INCLUSION_MAX_VERTICES]; /* by rank bit */
+    ULongLong       chunks;
+    atomic_ullong   next;     /* next chunk to take */
+    atomic_bool     stopped;
+    double          deadline;
+    pthread_mutex_t lock;
+    double          bound;    /* on 2 c */
+    bool            narrow;   /* 2 c is below 2^64, count modulo 2^64 */
+    UHugeInt        sum;      /* 2 c once all chunks are in */
+} HCInclusion;
+
+
+/*! The closed walks of pts steps from start inside T, given the walks of
+two steps in w2, summed in type Sum: closedWalks modulo 2^UHugeInt_BIT 
+and closedWalksNarrow modulo 2^64, for graphs with fewer cycles.  v and
+w are scratch vectors of pts entries. */
+
+#define CLOSED_WALKS(name, Sum)                                         \
+static Sum                                                              \
+name(HCInclusion *ie, BitSet T, UInt *w2, Sum *v, Sum *w)               \
+{                                                                       \
+    BitSet      rest, nb;                                               \
+    Sum         sum, *t;                                                \
+    UInt        u, step;                                                \
+                                                                        \
+    UInt        h = ie->pts / 2;                                        \
+                                                                        \
+    /* v = A_T^h e_start, from the walks of one or two steps */         \
+                                                                        \
+    for (rest = T; rest; rest &= rest - 1) {                            \
+        u    = lowestBit(rest);                                         \
+        v[u] = h == 1 ? (ie->adj[ie->start] >> u) & 1 : w2[u];          \
+    }                                                                   \
+                                                                        \
+    for (step = 2; step < h; step++) {                                  \
+        for (rest = T; rest; rest &= rest - 1) {                        \
+            u   = lowestBit(rest);                                      \
+            sum = 0;                                                    \
+            for (nb = ie->adj[u] & T; nb; nb &= nb - 1)                 \
+                sum += v[lowestBit(nb)];                                \
+            w[u] = sum;                                                 \
+        }                                                               \
+        t = v; v = w; w = t;                                            \
+    }                                                                   \
+                                                                        \
+    sum = 0;                                                            \
+    for (rest = T; rest; rest &= rest - 1) {                            \
+        u = lowestBit(rest);                                            \
+        if (!(ie->pts & 1)) sum += v[u] * v[u];                         \
+        else for (nb = ie->adj[u] & T; nb; nb &= nb - 1)                \
+            sum += v[u] * v[lowestBit(nb)];                             \
+    }                                                                   \
+                                                                        \
+    return sum;                                                         \
+}
+
+CLOSED_WALKS(closedWalks, UHugeInt)
+CLOSED_WALKS(closedWalksNarrow, ULongLong)
+
+
+/*! Worker, adds the terms of the chunks it takes to ie->sum. */
+
+static void *
+sumChunks(void *arg)
+{
+    HCInclusion *ie = arg;
+    UHugeInt     v[HC_INCLUSION_MAX_VERTICES], w[HC_INCLUSION_MAX_VERTICES];
+    ULongLong    nv[HC_INCLUSION_MAX_VERTICES], nw[HC_INCLUSION_MAX_VERTICES];
+    UHugeInt     total = 0, walks;
+    ULongLong    narrow = 0, nwalks;
+    UInt         w2[HC_INCLUSION_MAX_VERTICES];
+    BitSet    all, T, X, nb, ends;
+    ULongLong    chunk, rank, first, last;
+    UInt         u, x;
+    
+    UInt         k = ie->pts - 1;
+    
+    all  = ie->pts == 64 ? ~(BitSet)0 : BIT(ie->pts) - 1;
+    ends = ie->adj[ie->start];
+    
+    while ((chunk = atomic_fetch_add(&ie->next, 1)) < ie->chunks) {
+        if (atomic_load(&ie->stopped)) break;
+        if (ie->deadline && monotonicSeconds() >= ie->deadline) {
+            atomic_store(&ie->stopped, true);
+            break;
+        }
+        
+        first = chunk << HC_INCLUSION_CHUNK;
+        last  = first + ((ULongLong)1 << HC_INCLUSION_CHUNK);
+        if (last > (ULongLong)1 << k) last = (ULongLong)1 << k;
+        
+        /* the set of the first rank, and its walks of two steps */
+        
+        X = 0;
+        for (rank = first ^ (first >> 1); rank; rank &= rank - 1) 
+            X |= BIT(ie->other[lowestBit(rank)]);
+        T = all & ~X;
+        
+        for (nb = all; nb; nb &= nb - 1) {
+            u     = lowestBit(nb);
+            w2[u] = bitCount(ie->adj[u] & ends & T);
+        }
+        
+        for (rank = first; ; ) {
+            if (ie->narrow) {
+                nwalks  = closedWalksNarrow(ie, T, w2, nv, nw);
+                narrow += bitCount(X) & 1 ? -nwalks : nwalks;
+            } else {
+                walks  = closedWalks(ie, T, w2, v, w);
+                total += bitCount(X) & 1 ? -walks : walks;
+            }
+            
+            if (++rank == last) break;
+            
+            /* the next set differs in the vertex of the lowest set bit */
+            
+            x  = ie->other[lowestBit(rank)];
+            X ^= BIT(x);
+            T ^= BIT(x);
+            
+            if (ends & BIT(x)) {
+                for (nb = ie->adj[x]; nb; nb &= nb - 1) {
+                    if (T & BIT(x)) w2[lowestBit(nb)]++;
+                    else w2[lowestBit(nb)]--;
+                }
+            }
+        }
+    }
+    
+    pthread_mutex_lock(&ie->lock);
+    ie->sum += ie->narrow ? narrow : total;
+    pthread_mutex_unlock(&ie->lock);
+    
+    return NULL;
+    
+} /* sumChunks */
+
+
+/*! Set up ie for g with its start vertex and bound, false when g has 
+fewer than 3 vertices or one of degree < 2. */
+
+static bool
+loadInclusion(HCInclusion *ie, Graph *g, double seconds)
+{
+    Vertex   x;
+    UInt     i, k;
+    double   orders = 1;
+    
+    ie->pts      = g->vertex_count;
+    ie->bound    = 1;
+    ie->sum      = 0;
+    ie->deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    atomic_store(&ie->next, 0);
+    atomic_store(&ie->stopped, false);
+    
+    if (ie->pts < 3 || !loadBitSets(g, ie->adj, &ie->start)) return false;
+    
+    for (x = 1; x <= (Vertex)ie->pts; x++) {
+        
+        /* a cycle in one direction is a choice of successor for each
+           vertex, and an order of the vertices after s */
+        
+        ie->bound *= g->degree[x];
+        if (x > 1) orders *= x - 1;
+    }
+    if (orders < ie->bound) ie->bound = orders;
+    ie->narrow = ie->bound < ldexp(1, 64);
+    
+    for (i = k = 0; i < ie->pts; i++) 
+        if (i != ie->start) ie->other[k++] = i;
+    
+    ie->chunks = k > HC_INCLUSION_CHUNK 
+                    ? (ULongLong)1 << (k - HC_INCLUSION_CHUNK) : 1;
+    
+    return true;
+    
+} /* loadInclusion */
+
+
+/*! The workers share the chunks, the caller sums alone when no thread
+starts. */
+
+HCSearchStatus
+countByInclusion(Graph *g, UInt threads, double seconds, UHugeInt *cycles, 
+                 Status *status)
+{
+    HCInclusion *ie;
+    pthread_t   *workers;
+    UInt         i, made;
+    bool         stopped;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count > HC_INCLUSION_MAX_VERTICES) 
+        return HC_SEARCH_UNDECIDED;
+    if (!threads) threads = 1;
+    
+    EM(ie, sizeof(HCInclusion), e0);
+    EM(workers, threads * sizeof(pthread_t), e1);
+    
+    if (!loadInclusion(ie, g, seconds)) {
+        free(workers);
+        free(ie);
+        return HC_SEARCH_EXHAUSTED;
+    }
+    
+    /* the sum would wrap */
+    
+    if (ie->bound >= ldexp(1, UHugeInt_BIT)) {
+        free(workers);
+        free(ie);
+        return HC_SEARCH_UNDECIDED;
+    }
+    
+    pthread_mutex_init(&ie->lock, NULL);
+    
+    for (made = 0; made < threads; made++) {
+        if (pthread_create(workers + made, NULL, sumChunks, ie)) break;
+    }
+    
+    if (!made) sumChunks(ie);
+    for (i = 0; i < made; i++) pthread_join(workers[i], NULL);
+    
+    pthread_mutex_destroy(&ie->lock);
+    
+    stopped = atomic_load(&ie->stopped);
+    if (!stopped) *cycles = (ie->narrow ? (ULongLong)ie->sum : ie->sum) / 2;
+    
+    free(workers);
+    free(ie);
+    
+    if (stopped) return HC_SEARCH_UNDECIDED;
+    return *cycles ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e1: free(ie);
+e0: *status = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* countByInclusion */
+
+
+/*! The sum on *arg threads, the fallback of countByTapeThenInclusion. */
+
+static HCSearchStatus
+inclusionAfterTape(Graph *g, void *arg, bool decide, double seconds, 
+                   UHugeInt *cycles, Status *status)
+{
+    return countByInclusion(g, *(UInt *)arg, seconds, cycles, status);
+    
+} /* inclusionAfterTape */
+
+
+/*! The sum follows about 2^(n-1) (n / 2 - 1) m / 2 arcs, half the edges
+lying inside an average T.  The budget does not count on the threads 
+running on separate processors. */
+
+HCSearchStatus
+countByTapeThenInclusion(Graph *g, UInt threads, bool prune, 
+                         double seconds, UHugeInt *cycles, Status *status)
+{
+    ULongLong       budget;
+    
+    UInt            n = g->vertex_count;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (n > HC_INCLUSION_AUTO_VERTICES) return HC_SEARCH_UNDECIDED;
+    if (!threads) threads = 1;
+    
+    budget = ((ULongLong)1 << (n - 1)) / HC_INCLUSION_ROTATION_ARCS 
+               * (n / 2) * (g->edge_count / 2 + 1) + 1;
+    
+    return searchTapeThen(g, false, prune, seconds, budget, 
+                          inclusionAfterTape, &threads, cycles, status);
+    
+} /* countByTapeThenInclusion */
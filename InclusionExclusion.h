@@ -0,0 +1,53 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef INCLUSIONEXCLUSION_H
+#define INCLUSIONEXCLUSION_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/* the sum takes graphs of at most HC_INCLUSION_MAX_VERTICES vertices,
+   countByTapeThenInclusion of at most HC_INCLUSION_AUTO_VERTICES (the 
+   sum has 2^(n-1) terms) */
+
+#define HC_INCLUSION_MAX_VERTICES  64
+#define HC_INCLUSION_AUTO_VERTICES 32
+
+/* count the Hamilton cycles of g as the inclusion-exclusion sum over 
+   the vertex subsets T of closed walks of n steps inside T, the subsets
+   shared out to threads workers (0 for 1).  HC_SEARCH_UNDECIDED is 
+   returned when the time limit is reached (seconds, 0 for none), g is 
+   too large, or the product of the degrees and (n - 1)! both reach 
+   2^UHugeInt_BIT, where the count could wrap.  Graphs of at most 35 
+   vertices (21 with a 64 bit UHugeInt) are always counted. */
+HCSearchStatus countByInclusion(Graph *g, UInt threads, double seconds,
+                                UHugeInt *cycles, Status *status);
+
+/* the tape engine first, for as many rotations as the sum would cost,
+   then the sum if the tape has not finished, see searchTapeThen.  When 
+   the time limit ends the tape *cycles holds the cycles found so far. */
+HCSearchStatus countByTapeThenInclusion(Graph *g, UInt threads, 
+                                        bool prune, double seconds,
+                                        UHugeInt *cycles, Status *status);
+
+#endif /* INCLUSIONEXCLUSION_H */
@@ -0,0 +1,198 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arch.h"
+#include "MemoTable.h"
+
+/* Entries are chained from a power of 2 sized bucket array on the low 
+   bits of the key, and kept on a doubly linked list in order of use.  
+   Index 0 is the list head and the end of every chain. */
+
+typedef struct memo_entry {
+    ULongLong key;
+    ULongLong check;
+    ULongLong value;
+    UInt      chain;      /* next entry of the bucket */
+    UInt      newer;      /* neighbours on the use list */
+    UInt      older;
+} MemoEntry;
+
+struct memo_table {
+    MemoEntry *entry;     /* capacity + 1 entries, entry 0 the list head */
+    UInt      *bucket;
+    UInt       mask;      /* bucket count - 1 */
+    UInt       capacity;
+    UInt       used;
+    MemoStatistics stats;
+};
+
+
+MemoTableRef
+allocateMemoTable(UInt entries, Status *status)
+{
+    MemoTableRef t;
+    UInt         b = 1;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    if (!entries) entries = 1;
+    while (b < entries) b <<= 1;
+    
+    EM(t,          sizeof(struct memo_table),          e0);
+    EM(t->entry,   (entries + 1) * sizeof(MemoEntry),  e1);
+    EM(t->bucket,  b * sizeof(UInt),                   e2);
+    
+    t->mask     = b - 1;
+    t->capacity = entries;
+    
+    return t;
+    
+e2: free(t->entry);
+e1: free(t);
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocateMemoTable */
+
+
+/*! Empty the table. */
+
+MemoTableRef
+initMemoTable(MemoTableRef t)
+{
+    if (!t) return NULL;
+    
+    memset(t->bucket, 0, (t->mask + 1) * sizeof(UInt));
+    memset(&t->stats, 0, sizeof(MemoStatistics));
+    
+    t->entry->newer = t->entry->older = 0;
+    t->used = 0;
+    
+    return t;
+    
+} /* initMemoTable */
+
+
+void
+releaseMemoTable(MemoTableRef t)
+{
+    if (!t) return;
+    
+    free(t->bucket);
+    free(t->entry);
+    free(t);
+    
+} /* releaseMemoTable */
+
+
+static inline void
+unlinkEntry(MemoEntry *m, UInt i)
+{
+    m[m[i].newer].older = m[i].older;
+    m[m[i].older].newer = m[i].newer;
+}
+
+
+static inline void
+pushNewest(MemoEntry *m, UInt i)
+{
+    m[i].newer       = 0;
+    m[i].older       = m->older;
+    m[m->older].newer = i;
+    m->older         = i;
+}
+
+
+/*! Find the value stored under key and check, marking it the most 
+recently used. */
+
+bool
+lookupMemoTable(MemoTableRef t, ULongLong key, ULongLong check, 
+                ULongLong *value)
+{
+    MemoEntry *m = t->entry;
+    UInt       i = t->bucket[key & t->mask];
+    
+    while (i && (m[i].key != key || m[i].check != check)) i = m[i].chain;
+    
+    if (!i) {
+        t->stats.misses++;
+        return false;
+    }
+    
+    unlinkEntry(m, i);
+    pushNewest(m, i);
+    
+    *value = m[i].value;
+    t->stats.hits++;
+    return true;
+    
+} /* lookupMemoTable */
+
+
+/*! Store value under key and check, evicting the least recently used 
+entry when the table is full.  The key must not be in the table. */
+
+void
+storeMemoTable(MemoTableRef t, ULongLong key, ULongLong check, 
+               ULongLong value)
+{
+    MemoEntry *m = t->entry;
+    UInt       i, *p;
+    
+    if (t->used < t->capacity) i = ++t->used;
+    else {
+        
+        /* take the oldest entry off its chain */
+        
+        i = m->newer;
+        p = t->bucket + (m[i].key & t->mask);
+        while (*p != i) p = &m[*p].chain;
+        *p = m[i].chain;
+        
+        unlinkEntry(m, i);
+        t->stats.evictions++;
+    }
+    
+    m[i].key   = key;
+    m[i].check = check;
+    m[i].value = value;
+    
+    p          = t->bucket + (key & t->mask);
+    m[i].chain = *p;
+    *p         = i;
+    
+    pushNewest(m, i);
+    
+} /* storeMemoTable */
+
+
+void
+getMemoStatistics(MemoTableRef t, MemoStatistics *st)
+{
+    *st          = t->stats;
+    st->entries  = t->used;
+    st->capacity = t->capacity;
+    
+} /* getMemoStatistics */
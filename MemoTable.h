@@ -0,0 +1,50 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef MEMOTABLE_H
+#define MEMOTABLE_H
+
+#include "Arch.h"
+#include "Graph.h"
+
+/*! Bounded table of values keyed on 128 bit hashes.  Once full, storing
+    a new key evicts the least recently used one. */
+
+typedef struct memo_table * MemoTableRef;  /* opaque type */
+
+typedef struct memo_statistics {
+    ULongLong hits;        /*!< lookups that found their key         */
+    ULongLong misses;      /*!< lookups that did not                 */
+    ULongLong evictions;   /*!< entries dropped to make room         */
+    UInt      entries;     /*!< keys held                            */
+    UInt      capacity;    /*!< keys the table can hold              */
+} MemoStatistics;
+
+MemoTableRef allocateMemoTable(UInt entries, Status *status);
+MemoTableRef initMemoTable(MemoTableRef t);
+void releaseMemoTable(MemoTableRef t);
+
+bool lookupMemoTable(MemoTableRef t, ULongLong key, ULongLong check, 
+                     ULongLong *value);
+void storeMemoTable(MemoTableRef t, ULongLong key, ULongLong check, 
+                    ULongLong value);
+void getMemoStatistics(MemoTableRef t, MemoStatistics *st);
+
+#endif /* MEMOTABLE_H */
@@ -0,0 +1,770 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+#include "TapeBudget.h"
+#include "PathDecomposition.h"
+
+/* NOTES:
+
+An order of the vertices is a path decomposition of g: the bag of the
+i-th vertex v holds v and the frontier, the vertices placed before v 
+with a neighbour at or after v.  Orders are grown greedily, each step 
+placing the vertex next to the frontier that leaves it smallest, from 
+a minimum degree vertex and then from the last vertex of the order 
+before, and the bandwidth order of VertexOrder.c is tried as well.
+
+The count places one vertex at a time and decides the edges from v 
+back to the frontier one at a time, in the cycle or not.  A state 
+gives each frontier vertex a code of 4 bits: no cycle edge yet, two 
+cycle edges, or one, and then a label shared with the other end of 
+its path, the paths labelled 2, 3, ... in the order of their first 
+end so that equal states have equal keys.  The number of edge sets 
+reaching each state is kept in a hash table, one for the states 
+before an edge and one for those after.  A vertex leaves the frontier
+after its last edge and only with two cycle edges.  The ends of one 
+path are joined only at the last vertex, when every other frontier 
+vertex has two cycle edges, and that edge set is a Hamilton cycle.
+
+A frontier of w vertices has at most sum C(w,2k) (2k-1)!! 2^(w-2k) 
+states, far fewer on planar graphs met in order, and the cost model 
+takes that bound at each edge. */
+
+typedef UHugeInt PathKey;
+
+#define SLOT_BITS  4
+#define SLOT_MASK  15
+#define CODE_FREE  0
+#define CODE_DONE  1
+#define CODE_PATH  2     /* first path label */
+#define CODE_NEW   15    /* not a label while two frontier vertices are
+                            free */
+
+/* greedy orders tried, from different start vertices */
+
+#define HC_PATH_STARTS 4
+
+/* one tape rotation costs about as much as this many states followed by
+   the count */
+
+#define HC_PATH_ROTATION_STATES 128
+
+typedef struct path_entry {
+    PathKey   key;
+    UHugeInt  count;
+    UInt      chain;      /* next entry of the bucket */
+} PathEntry;
+
+typedef struct path_table {
+    PathEntry *entry;     /* capacity + 1 entries, entry 0 ends chains */
+    UInt      *bucket;
+    UInt       mask;      /* bucket count - 1 */
+    UInt       capacity;
+    UInt       used;
+} PathTable;
+
+
+/*! The frontier grows by one when v has neighbours after it and 
+shrinks by the neighbours before v that have no other left. */
+
+static inline int
+frontierChange(Graph *g, Vertex v, UInt *left, bool *placed)
+{
+    Arc *a;
+    int  change = left[v] > 0;
+    
+    for (a = g->adj_lists[v]; a; a = a->next) 
+        if (placed[a->target] && left[a->target] == 1) change--;
+    
+    return change;
+    
+} /* frontierChange */
+
+
+/*! The states of a frontier of w vertices, at most. */
+
+static double
+frontierStates(UInt w)
+{
+    double  sum = 0, choose = 1, pairs = 1, ends;
+    UInt    k;
+    
+    for (k = 0; 2 * k <= w; k++) {
+        
+        /* choose = C(w, 2k), pairs = (2k - 1)!! */
+        
+        sum    += choose * pairs * ldexp(1, w - 2 * k);
+        ends    = w - 2.0 * k;
+        choose *= ends * (ends - 1) / ((2.0 * k + 1) * (2.0 * k + 2));
+        pairs  *= 2 * k + 1;
+    }
+    
+    return sum;
+    
+} /* frontierStates */
+
+
+/*! Place the vertices of g in the order given or, when greedy, starting
+from start and choosing each next vertex.  left and placed have 
+vertex_count + 1 entries, front vertex_count.  Returns the width, the
+largest frontier plus one, and adds the estimated states followed to
+*cost when cost is not NULL. */
+
+static UInt
+placeVertices(Graph *g, Vertex *order, bool greedy, Vertex start, 
+              UInt *left, bool *placed, Vertex *front, double *cost)
+{
+    Arc     *a;
+    Vertex   x, y;
+    UInt     i, j, k, f = 0, width = 0;
+    int      change, least;
+    
+    UInt     pts = g->vertex_count;
+    
+    for (x = 1; x <= (Vertex)pts; x++) {
+        left[x]   = g->degree[x];
+        placed[x] = false;
+    }
+    
+    for (i = 0; i < pts; i++) {
+        if (!greedy) x = order[i];
+        else if (!i) x = start;
+        else {
+            x     = 0;
+            least = INT_MAX;
+            for (j = 0; j < f; j++) {
+                for (a = g->adj_lists[front[j]]; a; a = a->next) {
+                    y = a->target;
+                    if (placed[y]) continue;
+                    change = frontierChange(g, y, left, placed);
+                    if (change < least) {
+                        least = change;
+                        x     = y;
+                    }
+                }
+            }
+            
+            /* an empty frontier, start the next component */
+            
+            if (!x) {
+                for (y = 1; y <= (Vertex)pts; y++) 
+                    if (!placed[y] && (!x || g->degree[y] < g->degree[x]))
+                        x = y;
+            }
+        }
+        if (greedy) order[i] = x;
+        
+        if (f + 1 > width) width = f + 1;
+        if (cost) {
+            *cost += (g->degree[x] - left[x] + 1) 
+                       * fmin(frontierStates(f + 1), HC_PATH_MAX_STATES);
+        }
+        
+        placed[x] = true;
+        for (a = g->adj_lists[x]; a; a = a->next) left[a->target]--;
+        
+        for (j = k = 0; j < f; j++) 
+            if (left[front[j]]) front[k++] = front[j];
+        f = k;
+        if (left[x]) front[f++] = x;
+    }
+    
+    return width;
+    
+} /* placeVertices */
+
+
+/*! The order of smallest width found, written to order, and its 
+estimated states added to *cost when cost is not NULL.  0 when out of
+memory. */
+
+static UInt
+findOrder(Graph *g, Vertex *order, double *cost, Status *status)
+{
+    VArray  *bw;
+    Vertex  *trial, *front, start, x;
+    UInt    *left, width = UInt_MAX, w, r;
+    bool    *placed;
+    
+    UInt     pts = g->vertex_count;
+    
+    EM(left,   (pts + 1) * sizeof(UInt),   e0);
+    EM(placed, (pts + 1) * sizeof(bool),   e1);
+    EM(front,  pts * sizeof(Vertex),       e2);
+    EM(trial,  pts * sizeof(Vertex),       e3);
+    
+    bw = sortVerticesBandwidth(initVArray(allocateVArray(pts, status)), 
+                               g, status);
+    if (!bw) goto e4;
+    
+    /* greedy orders from a minimum degree vertex, then from the last 
+       vertex of the order before, far from its start */
+    
+    start = 1;
+    for (x = 2; x <= (Vertex)pts; x++) 
+        if (g->degree[x] < g->degree[start]) start = x;
+    
+    for (r = 0; r < HC_PATH_STARTS; r++) {
+        w = placeVertices(g, trial, true, start, left, placed, front, NULL);
+        if (w < width) {
+            width = w;
+            memcpy(order, trial, pts * sizeof(Vertex));
+        }
+        if (trial[pts - 1] == start) break;
+        start = trial[pts - 1];
+    }
+    
+    w = placeVertices(g, bw->array, false, 0, left, placed, front, NULL);
+    if (w < width) {
+        width = w;
+        memcpy(order, bw->array, pts * sizeof(Vertex));
+    }
+    
+    if (cost) placeVertices(g, order, false, 0, left, placed, front, cost);
+    
+    releaseVArray(bw);
+    free(trial);
+    free(front);
+    free(placed);
+    free(left);
+    
+    return width;
+    
+e4: free(trial);
+e3: free(front);
+e2: free(placed);
+e1: free(left);
+e0: *status = STATUS_NO_MEM;
+    return 0;
+    
+} /* findOrder */
+
+
+UInt
+pathDecompositionWidth(Graph *g, VArray *order, Status *status)
+{
+    CHECK_RETURN_VAL(*status, 0);
+    if (!g->vertex_count) return 0;
+    
+    return findOrder(g, order->array, NULL, status);
+    
+} /* pathDecompositionWidth */
+
+
+double
+pathDecompositionCost(Graph *g, Status *status)
+{
+    Vertex  *order;
+    double   cost = 0;
+    UInt     width;
+    
+    CHECK_RETURN_VAL(*status, HUGE_VAL);
+    if (!g->vertex_count) return 0;
+    
+    EM(order, g->vertex_count * sizeof(Vertex), e0);
+    
+    width = findOrder(g, order, &cost, status);
+    free(order);
+    
+    return width && width <= HC_PATH_MAX_FRONTIER ? cost : HUGE_VAL;
+    
+e0: *status = STATUS_NO_MEM;
+    return HUGE_VAL;
+    
+} /* pathDecompositionCost */
+
+
+static inline UInt
+hashKey(PathKey key, UInt mask)
+{
+    ULongLong h = (ULongLong)key;
+    
+#if UHugeInt_BIT > 64
+    h ^= (ULongLong)(key >> 64) * 0xc2b2ae3d27d4eb4fULL;
+#endif
+    h *= 0x9e3779b97f4a7c15ULL;
+    
+    return (UInt)(h >> 32) & mask;
+    
+} /* hashKey */
+
+
+static bool
+allocatePathTable(PathTable *t, UInt entries)
+{
+    EM(t->entry,  (entries + 1) * sizeof(PathEntry), e0);
+    EM(t->bucket, entries * sizeof(UInt),            e1);
+    
+    memset(t->bucket, 0, entries * sizeof(UInt));
+    t->mask     = entries - 1;
+    t->capacity = entries;
+    t->used     = 0;
+    
+    return true;
+    
+e1: free(t->entry);
+e0: return false;
+    
+} /* allocatePathTable */
+
+
+/*! Double the entries and buckets of t, false when that passes 
+HC_PATH_MAX_STATES or memory runs out. */
+
+static bool
+growPathTable(PathTable *t, Status *status)
+{
+    PathEntry *entry;
+    UInt      *bucket, b, i;
+    
+    UInt       entries = 2 * t->capacity;
+    
+    if (entries > HC_PATH_MAX_STATES) return false;
+    
+    EM(bucket, entries * sizeof(UInt), e0);
+    if (!(entry = realloc(t->entry, (entries + 1) * sizeof(PathEntry)))) {
+        free(bucket);
+        goto e0;
+    }
+    
+    free(t->bucket);
+    t->entry    = entry;
+    t->bucket   = bucket;
+    t->mask     = entries - 1;
+    t->capacity = entries;
+    
+    memset(bucket, 0, entries * sizeof(UInt));
+    for (i = 1; i <= t->used; i++) {
+        b              = hashKey(entry[i].key, t->mask);
+        entry[i].chain = bucket[b];
+        bucket[b]      = i;
+    }
+    
+    return true;
+    
+e0: *status = STATUS_NO_MEM;
+    return false;
+    
+} /* growPathTable */
+
+
+/*! Empty t, clearing only the buckets in use. */
+
+static void
+clearPathTable(PathTable *t)
+{
+    UInt i;
+    
+    for (i = 1; i <= t->used; i++) 
+        t->bucket[hashKey(t->entry[i].key, t->mask)] = 0;
+    t->used = 0;
+    
+} /* clearPathTable */
+
+
+static void
+releasePathTable(PathTable *t)
+{
+    free(t->bucket);
+    free(t->entry);
+    
+} /* releasePathTable */
+
+
+/*! Add count to the state key, false when t is full. */
+
+static bool
+addState(PathTable *t, PathKey key, UHugeInt count, Status *status)
+{
+    UInt    i;
+    
+    UInt    b = hashKey(key, t->mask);
+    
+    for (i = t->bucket[b]; i; i = t->entry[i].chain) {
+        if (t->entry[i].key == key) {
+            t->entry[i].count += count;
+            return true;
+        }
+    }
+    
+    if (t->used == t->capacity) {
+        if (!growPathTable(t, status)) return false;
+        b = hashKey(key, t->mask);
+    }
+    
+    i = ++t->used;
+    t->entry[i].key   = key;
+    t->entry[i].count = count;
+    t->entry[i].chain = t->bucket[b];
+    t->bucket[b]      = i;
+    
+    return true;
+    
+} /* addState */
+
+
+static inline UInt
+slotCode(PathKey key, UInt s)
+{
+    return (UInt)(key >> (SLOT_BITS * s)) & SLOT_MASK;
+    
+} /* slotCode */
+
+
+static inline PathKey
+setSlotCode(PathKey key, UInt s, UInt c)
+{
+    return (key & ~((PathKey)SLOT_MASK << (SLOT_BITS * s))) 
+             | (PathKey)c << (SLOT_BITS * s);
+    
+} /* setSlotCode */
+
+
+/*! Relabel the paths of key in the order of their first end. */
+
+static PathKey
+canonicalKey(PathKey key, UInt slots)
+{
+    UInt     map[SLOT_MASK + 1] = { 0 };
+    UInt     s, c, next = CODE_PATH;
+    PathKey  out = 0;
+    
+    for (s = 0; s < slots; s++) {
+        c = slotCode(key, s);
+        if (c >= CODE_PATH) {
+            if (!map[c]) map[c] = next++;
+            c = map[c];
+        }
+        out |= (PathKey)c << (SLOT_BITS * s);
+    }
+    
+    return out;
+    
+} /* canonicalKey */
+
+
+/*! Decide the edge between the frontier slots a and b in every state of
+cur, into nxt.  ones has CODE_DONE in every frontier slot, and the 
+cycles the edge closes are added to *cycles when last.  False when nxt 
+is full. */
+
+static bool
+branchEdge(PathTable *cur, PathTable *nxt, UInt a, UInt b, UInt slots, 
+           PathKey ones, bool last, UHugeInt *cycles, Status *status)
+{
+    PathEntry *e, *end;
+    PathKey    key, ends;
+    UInt       ca, cb, s;
+    
+    ends = (PathKey)SLOT_MASK << (SLOT_BITS * a) 
+             | (PathKey)SLOT_MASK << (SLOT_BITS * b);
+    
+    for (e = cur->entry + 1, end = e + cur->used; e < end; e++) {
+        
+        /* without the edge */
+        
+        if (!addState(nxt, e->key, e->count, status)) return false;
+        
+        /* with it */
+        
+        ca = slotCode(e->key, a);
+        cb = slotCode(e->key, b);
+        if (ca == CODE_DONE || cb == CODE_DONE) continue;
+        
+        if (ca == CODE_FREE && cb == CODE_FREE) {
+            key = setSlotCode(setSlotCode(e->key, a, CODE_NEW), b, CODE_NEW);
+        } else if (ca == CODE_FREE) {
+            key = setSlotCode(setSlotCode(e->key, a, cb), b, CODE_DONE);
+        } else if (cb == CODE_FREE) {
+            key = setSlotCode(setSlotCode(e->key, b, ca), a, CODE_DONE);
+        } else if (ca == cb) {
+            if (last && (e->key & ~ends) == (ones & ~ends)) 
+                *cycles += e->count;
+            continue;
+        } else {
+            
+            /* join two paths, the far end of b's path takes a's label */
+            
+            key = setSlotCode(setSlotCode(e->key, a, CODE_DONE), b, 
+                              CODE_DONE);
+            for (s = 0; s < slots; s++) {
+                if (slotCode(key, s) == cb) {
+                    key = setSlotCode(key, s, ca);
+                    break;
+                }
+            }
+        }
+        
+        if (!addState(nxt, canonicalKey(key, slots), e->count, status)) 
+            return false;
+    }
+    
+    return true;
+    
+} /* branchEdge */
+
+
+/*! The dynamic program over order, stopping at the first cycle when 
+decide. */
+
+static HCSearchStatus
+runPaths(Graph *g, Vertex *order, bool decide, double deadline, 
+         UHugeInt *cycles, Status *status)
+{
+    PathTable       tab[2], *cur, *nxt, *t;
+    PathEntry      *e, *end;
+    PathKey         ones = 0, gone;
+    Arc            *a;
+    Vertex          v, u;
+    UInt           *pos, *slot, *left, i, s, slots = 0, used = 0;
+    HCSearchStatus  result = HC_SEARCH_EXHAUSTED;
+    
+    UInt            pts = g->vertex_count;
+    
+    *cycles = 0;
+    
+    EM(pos,  (pts + 1) * sizeof(UInt), e0);
+    EM(slot, (pts + 1) * sizeof(UInt), e1);
+    EM(left, (pts + 1) * sizeof(UInt), e2);
+    if (!allocatePathTable(tab,     1 << 10)) goto e3;
+    if (!allocatePathTable(tab + 1, 1 << 10)) goto e4;
+    
+    for (i = 0; i < pts; i++) {
+        pos[order[i]]  = i;
+        left[order[i]] = g->degree[order[i]];
+    }
+    
+    cur = tab;
+    nxt = tab + 1;
+    addState(cur, 0, 1, status);
+    
+    for (i = 0; i < pts && cur->used; i++) {
+        v = order[i];
+        
+        /* v takes the lowest free slot */
+        
+        for (s = 0; used & (1U << s); s++) ;
+        slot[v] = s;
+        used   |= 1U << s;
+        ones   |= (PathKey)CODE_DONE << (SLOT_BITS * s);
+        if (s >= slots) slots = s + 1;
+        
+        for (a = g->adj_lists[v]; a; a = a->next) {
+            u = a->target;
+            if (pos[u] > i) continue;
+            
+            if (deadline && monotonicSeconds() >= deadline) {
+                result = HC_SEARCH_UNDECIDED;
+                goto done;
+            }
+            if (!branchEdge(cur, nxt, slot[u], s, slots, ones, 
+                            i + 1 == pts, cycles, status)) {
+                result = HC_SEARCH_UNDECIDED;
+                goto done;
+            }
+            if (decide && *cycles) {
+                result = HC_SEARCH_CYCLE;
+                goto done;
+            }
+            
+            clearPathTable(cur);
+            t = cur; cur = nxt; nxt = t;
+        }
+        
+        /* vertices with no neighbours left leave the frontier, each 
+           with two cycle edges */
+        
+        gone = 0;
+        for (a = g->adj_lists[v]; a; a = a->next) {
+            u = a->target;
+            if (pos[u] > i) continue;
+            left[v]--;
+            if (--left[u]) continue;
+            gone |= (PathKey)SLOT_MASK << (SLOT_BITS * slot[u]);
+            used &= ~(1U << slot[u]);
+        }
+        if (!left[v]) {
+            gone |= (PathKey)SLOT_MASK << (SLOT_BITS * s);
+            used &= ~(1U << s);
+        }
+        
+        if (gone && i + 1 < pts) {
+            for (e = cur->entry + 1, end = e + cur->used; e < end; e++) {
+                if ((e->key & gone) != (ones & gone)) continue;
+                if (!addState(nxt, e->key & ~gone, e->count, status)) {
+                    result = HC_SEARCH_UNDECIDED;
+                    goto done;
+                }
+            }
+            clearPathTable(cur);
+            t = cur; cur = nxt; nxt = t;
+        }
+        ones &= ~gone;
+    }
+    
+    if (*cycles) result = HC_SEARCH_CYCLE;
+    
+done:
+    releasePathTable(tab + 1);
+    releasePathTable(tab);
+    free(left);
+    free(slot);
+    free(pos);
+    
+    return result;
+    
+e4: releasePathTable(tab);
+e3: free(left);
+e2: free(slot);
+e1: free(pos);
+e0: *status = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* runPaths */
+
+
+/*! Order g and run the program, when the width allows. */
+
+static HCSearchStatus
+searchPaths(Graph *g, bool decide, double seconds, UHugeInt *cycles, 
+            Status *status)
+{
+    Vertex         *order;
+    HCSearchStatus  result = HC_SEARCH_UNDECIDED;
+    UInt            width;
+    double          deadline;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count < 3) return HC_SEARCH_EXHAUSTED;
+    
+    deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    EM(order, g->vertex_count * sizeof(Vertex), e0);
+    
+    width = findOrder(g, order, NULL, status);
+    if (width && width <= HC_PATH_MAX_FRONTIER) 
+        result = runPaths(g, order, decide, deadline, cycles, status);
+    
+    free(order);
+    return result;
+    
+e0: *status = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* searchPaths */
+
+
+HCSearchStatus
+countByPathDecomposition(Graph *g, double seconds, UHugeInt *cycles, 
+                         Status *status)
+{
+    return searchPaths(g, false, seconds, cycles, status);
+    
+} /* countByPathDecomposition */
+
+
+HCSearchStatus
+decideByPathDecomposition(Graph *g, double seconds, Status *status)
+{
+    UHugeInt cycles;
+    
+    return searchPaths(g, true, seconds, &cycles, status);
+    
+} /* decideByPathDecomposition */
+
+
+/*! The program over the order in arg, the fallback of tapeThenPaths. */
+
+static HCSearchStatus
+pathsAfterTape(Graph *g, void *arg, bool decide, double seconds, 
+               UHugeInt *cycles, Status *status)
+{
+    double end = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    return runPaths(g, (Vertex *)arg, decide, end, cycles, status);
+    
+} /* pathsAfterTape */
+
+
+/*! The tape engine on a budget of rotations from the cost model, then 
+the program over the same order if the budget ran out. */
+
+static HCSearchStatus
+tapeThenPaths(Graph *g, bool decide, bool prune, double seconds, 
+              UHugeInt *cycles, Status *status)
+{
+    Vertex         *order;
+    HCSearchStatus  result = HC_SEARCH_UNDECIDED;
+    double          cost = 0;
+    UInt            width;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    if (g->vertex_count < 3) return HC_SEARCH_EXHAUSTED;
+    
+    EM(order, g->vertex_count * sizeof(Vertex), e0);
+    
+    width = findOrder(g, order, &cost, status);
+    if (width && width <= HC_PATH_MAX_FRONTIER) 
+        result = searchTapeThen(g, decide, prune, seconds, 
+                                cost / HC_PATH_ROTATION_STATES + 1, 
+                                pathsAfterTape, order, cycles, status);
+    
+    free(order);
+    return result;
+    
+e0: *status = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+    
+} /* tapeThenPaths */
+
+
+HCSearchStatus
+countByTapeThenPaths(Graph *g, bool prune, double seconds, 
+                     UHugeInt *cycles, Status *status)
+{
+    return tapeThenPaths(g, false, prune, seconds, cycles, status);
+    
+} /* countByTapeThenPaths */
+
+
+HCSearchStatus
+decideByTapeThenPaths(Graph *g, bool prune, double seconds, 
+                      Status *status)
+{
+    UHugeInt cycles;
+    
+    return tapeThenPaths(g, true, prune, seconds, &cycles, status);
+    
+} /* decideByTapeThenPaths */
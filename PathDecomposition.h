@@ -0,0 +1,76 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+
+#ifndef PATHDECOMPOSITION_H
+#define PATHDECOMPOSITION_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/* the count keeps 4 bits for each frontier vertex in a state of 
+   UHugeInt_BIT bits, so frontiers of at most HC_PATH_MAX_FRONTIER 
+   vertices (their path ends need at most 14 labels), and gives up when
+   a step holds more than HC_PATH_MAX_STATES states.  A state takes 52 
+   bytes with its bucket and a step keeps two tables, so the cap bounds
+   the count to about 110 MB.  The tools pick the engine when 
+   pathDecompositionCost is at most HC_PATH_AUTO_COST. */
+
+#if UHugeInt_BIT > 64
+#define HC_PATH_MAX_FRONTIER  28
+#else
+#define HC_PATH_MAX_FRONTIER  16
+#endif
+#define HC_PATH_MAX_STATES    (1 << 20)
+#define HC_PATH_AUTO_COST     1e9
+
+/* a vertex order of g with a small frontier, the vertices placed before
+   the i-th with a neighbour at or after it.  order has vertex_count 
+   entries, the largest frontier plus one, the width of the path 
+   decomposition, is returned (0 when out of memory). */
+UInt pathDecompositionWidth(Graph *g, VArray *order, Status *status);
+
+/* an estimate of the states followed by the count over the order of 
+   pathDecompositionWidth, HUGE_VAL when the width is above 
+   HC_PATH_MAX_FRONTIER. */
+double pathDecompositionCost(Graph *g, Status *status);
+
+/* count the Hamilton cycles of g, or decide if there is one, by dynamic
+   programming over the path decomposition, in time about the cost 
+   above.  The count is taken modulo 2^UHugeInt_BIT.  HC_SEARCH_UNDECIDED is 
+   returned when the time limit is reached (seconds, 0 for none), the 
+   width is too large or a step holds too many states. */
+HCSearchStatus countByPathDecomposition(Graph *g, double seconds, 
+                                        UHugeInt *cycles, Status *status);
+HCSearchStatus decideByPathDecomposition(Graph *g, double seconds, 
+                                         Status *status);
+
+/* the tape engine first, for as many rotations as the dynamic program
+   would cost, then the program if the tape has not finished.  When the
+   time limit ends the tape *cycles holds the cycles found so far. */
+HCSearchStatus countByTapeThenPaths(Graph *g, bool prune, double seconds,
+                                    UHugeInt *cycles, Status *status);
+HCSearchStatus decideByTapeThenPaths(Graph *g, bool prune, double seconds,
+                                     Status *status);
+
+#endif /* PATHDECOMPOSITION_H */
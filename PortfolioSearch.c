@@ -0,0 +1,257 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+#include "PortfolioSearch.h"
+
+static HCConfig defaultConfigs[HC_PORTFOLIO_DEFAULT_SIZE] = {
+    { "desc",       false, false },
+    { "desc-prune", true,  false },
+    { "asc",        false, true  },
+    { "asc-prune",  true,  true  }
+};
+
+/*! State of one racing configuration. */
+
+typedef struct hc_racer {
+    HCPortfolioRef    portfolio;
+    UInt              index;
+    Graph            *graph;    /* private copy of the input graph */
+    VArray           *order;
+    HCStateRef        hc;
+    HCSearchStatus    status;
+    pthread_t         thread;
+} HCRacer;
+
+struct hc_portfolio {
+    UInt              size;
+    HCConfig         *configs;
+    HCPortfolioStats *stats;
+    HCRacer          *racers;
+    atomic_int        winner;
+    double            start;
+};
+
+
+HCPortfolioRef
+allocatePortfolio(UInt configs, Status *status)
+{
+    HCPortfolioRef p;
+    
+    CHECK_RETURN_VAL(*status, NULL);
+    
+    EM(p,          sizeof(struct hc_portfolio),         e0);
+    EM(p->configs, configs * sizeof(HCConfig),          e1);
+    EM(p->stats,   configs * sizeof(HCPortfolioStats),  e2);
+    EM(p->racers,  configs * sizeof(HCRacer),           e3);
+    
+    p->size = configs;
+    return p;
+    
+e3: free(p->stats);
+e2: free(p->configs);
+e1: free(p);
+e0: *status = STATUS_NO_MEM;
+    return NULL;
+    
+} /* allocatePortfolio */
+
+
+HCPortfolioRef
+initPortfolio(HCPortfolioRef p, HCConfig *configs)
+{
+    if (!p) return NULL;
+    
+    if (!configs) {
+        configs = defaultConfigs;
+        if (p->size > HC_PORTFOLIO_DEFAULT_SIZE) 
+            p->size = HC_PORTFOLIO_DEFAULT_SIZE;
+    }
+    
+    memcpy(p->configs, configs, p->size * sizeof(HCConfig));
+    memset(p->stats, 0, p->size * sizeof(HCPortfolioStats));
+    atomic_store(&p->winner, -1);
+    
+    return p;
+    
+} /* initPortfolio */
+
+
+void
+releasePortfolio(HCPortfolioRef p)
+{
+    if (!p) return;
+    
+    free(p->racers);
+    free(p->stats);
+    free(p->configs);
+    free(p);
+    
+} /* releasePortfolio */
+
+
+static void *
+race(void *arg)
+{
+    UInt            i;
+    SInt            none = -1;
+    
+    HCRacer        *r = arg;
+    HCPortfolioRef  p = r->portfolio;
+    
+    if (p->configs[r->index].prune) firstHamiltonianCycleWithPruning(r->hc);
+    else firstHamiltonianCycle(r->hc);
+    
+    r->status = getHCSearchStatus(r->hc);
+    
+    if (r->status == HC_SEARCH_UNDECIDED) return NULL;
+    
+    /* first definite answer wins, stop everyone else */
+    
+    if (atomic_compare_exchange_strong(&p->winner, &none, (SInt)r->index)) {
+        
+        p->stats[r->index].wins++;
+        p->stats[r->index].seconds += monotonicSeconds() - p->start;
+        
+        for (i = 0; i < p->size; i++) 
+            if (i != r->index) cancelHamiltonianCycleSearch(p->racers[i].hc);
+    }
+    
+    return NULL;
+    
+} /* race */
+
+
+static void
+releaseRacer(HCRacer *r)
+{
+    if (r->hc)    releaseHCState(r->hc);
+    if (r->order) releaseVArray(r->order);
+    if (r->graph) releaseGraph(r->graph);
+    
+} /* releaseRacer */
+
+
+HCSearchStatus
+runPortfolio(HCPortfolioRef p, Graph *g, Status *status)
+{
+    HCRacer        *r;
+    UInt            i, started;
+    SInt            w;
+    
+    HCSearchStatus  result = HC_SEARCH_UNDECIDED;
+    UInt            pts    = g->vertex_count;
+    
+    CHECK_RETURN_VAL(*status, result);
+    
+    memset(p->racers, 0, p->size * sizeof(HCRacer));
+    atomic_store(&p->winner, -1);
+    
+    /* give every configuration its own graph and search state before any
+       thread starts, so that the winner can always cancel the others */
+    
+    for (i = 0; i < p->size; i++) {
+        
+        r            = p->racers + i;
+        r->portfolio = p;
+        r->index     = i;
+        r->status    = HC_SEARCH_UNDECIDED;
+        r->graph     = copyGraph(g, status);
+        
+        CHECK_JUMP(*status, e0);
+        
+        r->order = initVArray(allocateVArray(pts, status));
+        CHECK_JUMP(*status, e0);
+        
+        if (p->configs[i].ascending) 
+            sortVerticesDegreeAsc(r->order, r->graph->degree);
+        else 
+            sortVerticesDegreeDesc(r->order, r->graph->degree);
+        
+        r->hc = allocateHCState(pts, status);
+        CHECK_JUMP(*status, e0);
+        
+        initHCState(r->hc, r->graph->degree, r->graph->adj_lists, r->order);
+    }
+    
+    p->start = monotonicSeconds();
+    
+    for (started = 0; started < p->size; started++) 
+        if (pthread_create(&p->racers[started].thread, NULL, 
+                            race, p->racers + started)) break;
+    
+    /* could not create a thread, settle for what is already running, or
+       run the first configuration here when nothing is */
+    
+    for (i = started ? started : 1; i < p->size; i++) 
+        cancelHamiltonianCycleSearch(p->racers[i].hc);
+    
+    if (!started) race(p->racers);
+    for (i = 0; i < started; i++) pthread_join(p->racers[i].thread, NULL);
+    
+    w = atomic_load(&p->winner);
+    if (w >= 0) result = p->racers[w].status;
+    
+e0: for (i = 0; i < p->size; i++) releaseRacer(p->racers + i);
+    return result;
+    
+} /* runPortfolio */
+
+
+UInt
+getPortfolioSize(HCPortfolioRef p)
+{
+    return p->size;
+} /* getPortfolioSize */
+
+
+/*! Index of the configuration that decided the last run, or the 
+portfolio size if no configuration did. */
+
+UInt
+getPortfolioWinner(HCPortfolioRef p)
+{
+    SInt w = atomic_load(&p->winner);
+    return w < 0 ? p->size : (UInt)w;
+} /* getPortfolioWinner */
+
+
+HCConfig *
+getPortfolioConfig(HCPortfolioRef p, UInt i)
+{
+    return p->configs + i;
+} /* getPortfolioConfig */
+
+
+void
+getPortfolioStatistics(HCPortfolioRef p, UInt i, HCPortfolioStats *st)
+{
+    *st = p->stats[i];
+} /* getPortfolioStatistics */
@@ -0,0 +1,63 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef PORTFOLIOSEARCH_H
+#define PORTFOLIOSEARCH_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+#define HC_PORTFOLIO_DEFAULT_SIZE 4
+
+/*! One way of running the search on a graph. */
+
+typedef struct hc_config {
+    char  *name;       /*!< Short name used when reporting.            */
+    bool   prune;      /*!< Use the pruning variant of the search.     */
+    bool   ascending;  /*!< Anchor vertices in ascending degree order. */
+} HCConfig;
+
+/*! Accumulated results for one configuration over all runs. */
+
+typedef struct hc_portfolio_stats {
+    ULongLong  wins;      /*!< Runs this configuration decided first.   */
+    double     seconds;   /*!< Wall time of the runs it won.            */
+} HCPortfolioStats;
+
+typedef struct hc_portfolio * HCPortfolioRef;  /* opaque type */
+
+HCPortfolioRef allocatePortfolio(UInt configs, Status *status);
+
+/* configs is copied, NULL selects the HC_PORTFOLIO_DEFAULT_SIZE default
+   configurations */
+HCPortfolioRef initPortfolio(HCPortfolioRef p, HCConfig *configs);
+void releasePortfolio(HCPortfolioRef p);
+
+/* race every configuration on a private copy of g, each on its own 
+   thread, the first to reach a definite answer cancels the others. */
+HCSearchStatus runPortfolio(HCPortfolioRef p, Graph *g, Status *status);
+
+UInt getPortfolioSize(HCPortfolioRef p);
+UInt getPortfolioWinner(HCPortfolioRef p);
+HCConfig *getPortfolioConfig(HCPortfolioRef p, UInt i);
+void getPortfolioStatistics(HCPortfolioRef p, UInt i, HCPortfolioStats *st);
+
+#endif /* PORTFOLIOSEARCH_H */
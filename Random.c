@@ -0,0 +1,59 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include "Arch.h"
+#include "Random.h"
+
+void
+seedRandom(RandomState *r, ULongLong seed)
+{
+    *r = seed;
+} /* seedRandom */
+
+
+ULongLong
+nextRandom(RandomState *r)
+{
+    ULongLong z = (*r += 0x9E3779B97F4A7C15ULL);
+    
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+    
+} /* nextRandom */
+
+
+/*! Uniform value in [0, n). */
+
+UInt
+randomBelow(RandomState *r, UInt n)
+{
+    return (UInt)(((nextRandom(r) >> 32) * (ULongLong)n) >> 32);
+} /* randomBelow */
+
+
+/*! Uniform value in [0, 1). */
+
+double
+randomUnit(RandomState *r)
+{
+    return (double)(nextRandom(r) >> 11) * (1.0 / 9007199254740992.0);
+} /* randomUnit */
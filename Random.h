@@ -0,0 +1,36 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include "Arch.h"
+
+/*! State of a splitmix64 generator.  Equal seeds give equal sequences on
+    every platform, so randomized runs can be reproduced. */
+
+typedef ULongLong RandomState;
+
+void      seedRandom(RandomState *r, ULongLong seed);
+ULongLong nextRandom(RandomState *r);
+UInt      randomBelow(RandomState *r, UInt n);
+double    randomUnit(RandomState *r);
+
+#endif /* RANDOM_H */
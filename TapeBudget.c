@@ -0,0 +1,125 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+#include "TapeBudget.h"
+
+/* NOTES:
+
+The engines that beat the tape engine on the graphs they fit, the 
+subset tables, the inclusion-exclusion sum and the path decomposition,
+take time fixed by the size of g, while the tape finishes much sooner
+on sparse graphs.  Each turns its cost into a budget of tape rotations
+and is run only when the tape has spent it, so that the tape never 
+costs much more than the engine it stands in for. */
+
+
+/*! Count with hc until it stops, or only find a cycle when decide. */
+
+static HCSearchStatus
+runTape(HCStateRef hc, bool decide, bool prune, ULongLong *c)
+{
+    HCSearchStatus  result;
+    bool            found;
+    
+    found = prune ? firstHamiltonianCycleWithPruning(hc)
+                  : firstHamiltonianCycle(hc);
+    if (found) {
+        (*c)++;
+        if (decide) return HC_SEARCH_CYCLE;
+        while (prune ? nextHamiltonianCycleWithPruning(hc)
+                     : nextHamiltonianCycle(hc)) (*c)++;
+    }
+    
+    result = getHCSearchStatus(hc);
+    if (result == HC_SEARCH_UNDECIDED) return result;
+    return *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+} /* runTape */
+
+
+HCSearchStatus
+searchTapeThen(Graph *g, bool decide, bool prune, double seconds, 
+               ULongLong budget, HCFallback fallback, void *arg, 
+               UHugeInt *cycles, Status *status)
+{
+    HCStateRef      hc;
+    VArray         *vo;
+    HCSearchStatus  result;
+    UHugeInt        total;
+    ULongLong       c = 0;
+    double          end, left = 0;
+    
+    UInt            n = g->vertex_count;
+    
+    *cycles = 0;
+    
+    CHECK_RETURN_VAL(*status, HC_SEARCH_UNDECIDED);
+    
+    end = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    
+    vo = sortVerticesDegreeDesc(initVArray(allocateVArray(n, status)), 
+                                g->degree);
+    hc = allocateHCState(n, status);
+    if (*status != STATUS_OK) {
+        if (vo) releaseVArray(vo);
+        if (hc) releaseHCState(hc);
+        return HC_SEARCH_UNDECIDED;
+    }
+    
+    initHCState(hc, g->degree, g->adj_lists, vo);
+    setHCSearchLimits(hc, budget, seconds);
+    result = runTape(hc, decide, prune, &c);
+    
+    /* out of rotations rather than time: the stopped search still holds
+       arcs of g */
+    
+    if (result == HC_SEARCH_UNDECIDED && getHCRotationCount(hc) >= budget &&
+        (!end || (left = end - monotonicSeconds()) > 0)) {
+        resetHCState(hc);
+        result = fallback(g, arg, decide, left, &total, status);
+        if (result != HC_SEARCH_UNDECIDED) {
+            *cycles = total;
+            goto done;
+        }
+        
+        /* the engine gave up with time left, the tape again without a 
+           budget */
+        
+        if (*status == STATUS_OK && 
+            (!end || (left = end - monotonicSeconds()) > 0)) {
+            c = 0;
+            initHCState(hc, g->degree, g->adj_lists, vo);
+            setHCSearchLimits(hc, 0, left);
+            result = runTape(hc, decide, prune, &c);
+        }
+    }
+    *cycles = c;
+    
+done:
+    releaseHCState(hc);
+    releaseVArray(vo);
+    
+    return result;
+    
+} /* searchTapeThen */
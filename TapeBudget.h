@@ -0,0 +1,49 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+
+#ifndef TAPEBUDGET_H
+#define TAPEBUDGET_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/* an exact engine run on g once the tape has spent its budget, with arg
+   as given to searchTapeThen and the seconds left (0 for none).  It 
+   decides g or counts its cycles into *cycles, and returns 
+   HC_SEARCH_UNDECIDED when it cannot. */
+typedef HCSearchStatus (*HCFallback)(Graph *g, void *arg, bool decide, 
+                                     double seconds, UHugeInt *cycles,
+                                     Status *status);
+
+/* the tape engine on g for budget rotations, only to the first cycle 
+   when decide, then fallback if the budget ran out before the time 
+   limit (seconds, 0 for none).  Should fallback not finish with time 
+   left the tape runs again without a budget.  When the time limit ends
+   the tape *cycles holds the cycles found so far. */
+HCSearchStatus searchTapeThen(Graph *g, bool decide, bool prune, 
+                              double seconds, ULongLong budget, 
+                              HCFallback fallback, void *arg, 
+                              UHugeInt *cycles, Status *status);
+
+#endif /* TAPEBUDGET_H */
@@ -0,0 +1,956 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "Timer.h"
+#include "HamiltonianPath.h"
+#include "VertexDeletion.h"
+
+/* NOTES:
+
+Each worker owns a copy of the graph and one state of n - 1 points.  To
+search g - v it swaps the labels of v and n in place and detaches the 
+arcs of n from its neighbours, so that g - v is the graph on 1..n-1 the
+state is initialized with; both are undone after the search.
+
+A Hamilton cycle C of g - v also answers other queries: when u is on C 
+with cycle neighbours a and b both adjacent to v, replacing u by v in C
+gives a Hamilton cycle of g - u.  Every cycle found is closed under 
+these exchanges, and a worker searching a subgraph answered that way is
+cancelled.
+
+The edge queries need no relabeling: the two arcs of e are unlinked for
+the search and put back after it.  Every cycle found, starting with one 
+of g itself, settles all the edges it misses.  Before an edge e of the
+cycle is searched, a 2-opt exchange (drop e and another cycle edge f, 
+join their ends the other way) is tried, which gives a cycle missing 
+both; so only edges on every cycle near the ones found are searched.
+
+The pair queries ask for a Hamilton path from s to t, each worker has a 
+path state over its copy.  A path s ... x y ... t with t adjacent to x 
+turns into the path s ... x t ... y, which answers the pair s, y; every
+path found is closed under these rotations at both ends, the rotated 
+paths waiting in a ring of n paths rather than on the stack (a path 
+rotated while the ring is full answers its pair but is not rotated 
+again).  A path with free ends is searched first, a graph without one 
+answers every pair. */
+
+typedef struct hc_deletion HCDeletion;
+
+/*! One worker and its private buffers. */
+
+typedef struct hc_deleter {
+    HCDeletion   *shared;
+    Graph        *graph;     /* private copy of the input graph */
+    HCStateRef    hc;
+    VArray       *order;
+    Vertex       *cycle;     /* 2n + 1 entries */
+    Vertex       *witness;   /* cycle neighbours in g, 2(n + 1) entries */
+    Vertex       *stack;     /* holes and resume points of the exchanges */
+    Arc         **arcs;      /* the arc of each edge in the copy */
+    HCPathRef     path;      /* path state of the pair queries */
+    HCSearchStatus *searching; /* answer of the query searched or NULL */
+    pthread_t     thread;
+} HCDeleter;
+
+struct hc_deletion {
+    Graph          *graph;
+    UInt            pts;
+    bool            prune;
+    double          deadline;
+    VArray         *order;   /* anchor order of g */
+    HCSearchStatus *result;
+    UInt            queries;
+    Vertex         *edges;   /* end pairs from listEdges */
+    bool            paths;   /* the queries are vertex pairs */
+    Vertex         *seq;     /* a cycle of g in order, with its inverse */
+    Vertex         *at;
+    Vertex         *ring;    /* paths waiting to be rotated, pts of pts */
+    UInt            first;   /* ring slot of the next path */
+    UInt            waiting;
+    HCDeleter      *workers;
+    UInt            threads;
+    atomic_uint     next;    /* next vertex to take */
+    pthread_mutex_t lock;    /* guards result, searching and stats */
+    HCDeletionStatistics stats;
+};
+
+
+/*! Exchange the labels x and y in the adjacency lists and degrees of g. */
+
+static void
+swapLabels(Graph *g, Vertex x, Vertex y)
+{
+    Arc     *a, *t;
+    UInt     d;
+    
+    Arc    **L = g->adj_lists;
+    
+    if (x == y) return;
+    
+    for (a = L[x]; a; a = a->next) a->cross->target = y;
+    for (a = L[y]; a; a = a->next) a->cross->target = x;
+    
+    t = L[x]; L[x] = L[y]; L[y] = t;
+    d = g->degree[x]; g->degree[x] = g->degree[y]; g->degree[y] = d;
+    
+} /* swapLabels */
+
+
+/*! Remove the arcs to x from the lists of its neighbours, or put them 
+back.  The arcs of x itself stay in L[x]. */
+
+static void
+detachVertex(Graph *g, Vertex x, bool attach)
+{
+    Arc     *a;
+    
+    Arc    **L = g->adj_lists;
+    
+    for (a = L[x]; a; a = a->next) {
+        if (attach) {
+            insertArc(L + a->target, a->cross);
+            g->degree[a->target]++;
+        } else {
+            removeArc(L + a->target, a->cross);
+            g->degree[a->target]--;
+        }
+    }
+    
+} /* detachVertex */
+
+
+/*! Record that query q has a Hamilton cycle, cancelling a worker 
+searching it.  Called with the lock held, returns false when q was 
+already answered. */
+
+static bool
+answer(HCDeletion *dl, UInt q)
+{
+    UInt    i;
+    
+    HCSearchStatus *r = dl->result + q;
+    
+    if (*r == HC_SEARCH_CYCLE) return false;
+    *r = HC_SEARCH_CYCLE;
+    
+    for (i = 0; i < dl->threads; i++) 
+        if (dl->workers[i].searching == r) 
+            cancelHamiltonianCycleSearch(dl->workers[i].hc);
+    
+    return true;
+    
+} /* answer */
+
+
+/*! Turn the cycle missing m, given by the cycle neighbours c1[x] and 
+c2[x] of each vertex x, into the one missing u by putting m in place of 
+u.  Moving m back undoes it. */
+
+static void
+moveHole(Vertex *c1, Vertex *c2, Vertex m, Vertex u)
+{
+    Vertex   a = c1[u];
+    Vertex   b = c2[u];
+    
+    c1[m] = a;
+    c2[m] = b;
+    c1[u] = c2[u] = 0;
+    if (c1[a] == u) c1[a] = m; else c2[a] = m;
+    if (c1[b] == u) c1[b] = m; else c2[b] = m;
+    
+} /* moveHole */
+
+
+/*! Answer every query reached from the Hamilton cycle of g - m held in
+w->witness, by putting m in place of a vertex u whose neighbours are 
+both adjacent to m, and so on from the cycle of g - u.  Each query is
+answered once, so at most n exchanges are pending: w->stack keeps the 
+hole of each and where its scan resumes, and the exchange is undone 
+when its scan ends.  Called with the lock held. */
+
+static void
+exchangeWitness(HCDeleter *w, Vertex m)
+{
+    Vertex  u;
+    
+    HCDeletion *dl  = w->shared;
+    UInt        pts = dl->pts;
+    bool      **M   = dl->graph->adj_matrix;
+    Vertex     *c1  = w->witness;
+    Vertex     *c2  = c1 + pts + 1;
+    Vertex     *top = w->stack;
+    
+    u = 1;
+    for (;;) {
+        for (; u <= (Vertex)pts; u++) {
+            if (u == m || dl->result[u] == HC_SEARCH_CYCLE) continue;
+            if (M[m][c1[u]] && M[m][c2[u]] && answer(dl, u)) break;
+        }
+        
+        if (u <= (Vertex)pts) {
+        
+            /* the cycle of g - u, m takes the place of u */
+            
+            dl->stats.witnessed++;
+            moveHole(c1, c2, m, u);
+            *top++ = m;
+            *top++ = u + 1;
+            m = u;
+            u = 1;
+            
+        } else {
+        
+            if (top == w->stack) break;
+            u = *--top;
+            moveHole(c1, c2, m, *--top);
+            m = *top;
+        }
+    }
+    
+} /* exchangeWitness */
+
+
+/*! Share the cycle found by worker w for g - v, read in the labels of 
+its swapped copy. */
+
+static void
+shareCycle(HCDeleter *w, Vertex v)
+{
+    Vertex  *c1 = w->witness, x, y, z;
+    
+    HCDeletion *dl  = w->shared;
+    UInt        pts = dl->pts;
+    UInt        n   = pts - 1;
+    
+    memset(c1, 0, 2 * (pts + 1) * sizeof(Vertex));
+    
+    /* vertex v of the copy is vertex pts of g */
+    
+    for (x = 1; x <= (Vertex)n; x++) {
+        z = x == v ? pts : x;
+        y = w->cycle[x];
+        c1[z] = y == v ? pts : y;
+        y = w->cycle[n + x];
+        c1[pts + 1 + z] = y == v ? pts : y;
+    }
+    
+    exchangeWitness(w, v);
+    
+} /* shareCycle */
+
+
+static void *
+deleteVertices(void *arg)
+{
+    HCDeleter      *w  = arg;
+    HCDeletion     *dl = w->shared;
+    Graph          *h  = w->graph;
+    UInt            pts = dl->pts;
+    Vertex          v, x, *o;
+    UInt            i;
+    bool            found;
+    double          seconds;
+    HCSearchStatus  r;
+    
+    while ((v = atomic_fetch_add(&dl->next, 1) + 1) <= (Vertex)pts) {
+        
+        pthread_mutex_lock(&dl->lock);
+        if (dl->result[v] == HC_SEARCH_CYCLE) {
+            pthread_mutex_unlock(&dl->lock);
+            continue;
+        }
+        seconds = 0;
+        if (dl->deadline) {
+            seconds = dl->deadline - monotonicSeconds();
+            if (seconds <= 0) {
+                dl->result[v] = HC_SEARCH_UNDECIDED;
+                pthread_mutex_unlock(&dl->lock);
+                continue;
+            }
+        }
+        w->searching = dl->result + v;
+        dl->stats.searched++;
+        pthread_mutex_unlock(&dl->lock);
+        
+        /* g - v is the copy on 1..n-1 after swapping v and n */
+        
+        swapLabels(h, v, pts);
+        detachVertex(h, pts, false);
+        
+        o = w->order->array;
+        for (i = 0; i < pts; i++) {
+            x = dl->order->array[i];
+            if (x == v) continue;
+            *o++ = x == (Vertex)pts ? v : x;
+        }
+        
+        initHCState(w->hc, h->degree, h->adj_lists, w->order);
+        setHCSearchLimits(w->hc, 0, seconds);
+        
+        found = dl->prune ? firstHamiltonianCycleWithPruning(w->hc)
+                          : firstHamiltonianCycle(w->hc);
+        r = getHCSearchStatus(w->hc);
+        
+        if (found) {
+            memset(w->cycle, 0, (2 * pts + 1) * sizeof(Vertex));
+            getCurrentHamiltonianCycle(w->hc, w->cycle);
+        }
+        
+        resetHCState(w->hc);
+        detachVertex(h, pts, true);
+        swapLabels(h, v, pts);
+        
+        pthread_mutex_lock(&dl->lock);
+        w->searching = NULL;
+        if (found) {
+            if (answer(dl, v)) shareCycle(w, v);
+        } else if (dl->result[v] != HC_SEARCH_CYCLE) {
+            dl->result[v] = r;
+        }
+        pthread_mutex_unlock(&dl->lock);
+    }
+    
+    return NULL;
+    
+} /* deleteVertices */
+
+
+/*! Reverse the cycle positions i to j, taken mod pts. */
+
+static void
+reversePath(Vertex *seq, Vertex *at, UInt i, UInt j, UInt pts)
+{
+    Vertex  t;
+    
+    for (; i < j; i++, j--) {
+        t = seq[i % pts];
+        seq[i % pts] = seq[j % pts];
+        seq[j % pts] = t;
+        at[seq[i % pts]] = i % pts;
+        at[seq[j % pts]] = j % pts;
+    }
+    
+} /* reversePath */
+
+
+/*! Settle every edge missed by the Hamilton cycle of g given by the cycle
+neighbours c1[x] and c2[x], then move the cycle off each open edge on it
+by 2-opt exchanges while there is one.  Called with the lock held. */
+
+static void
+shareEdgeCycle(HCDeletion *dl, Vertex *c1, Vertex *c2)
+{
+    Vertex  x, y, u, w, p;
+    UInt    i, j, e;
+    bool    moved;
+    
+    Vertex *seq = dl->seq;
+    Vertex *at  = dl->at;
+    UInt    pts = dl->pts;
+    bool  **M   = dl->graph->adj_matrix;
+    
+    for (i = 0, x = 1, p = 0; i < pts; i++) {
+        seq[i] = x;
+        at[x]  = i;
+        y = c1[x] != p ? c1[x] : c2[x];
+        p = x;
+        x = y;
+    }
+    
+    for (e = 0; e < dl->queries; e++) {
+        x = at[dl->edges[2 * e]];
+        y = at[dl->edges[2 * e + 1]];
+        j = x > y ? x - y : y - x;
+        if (j != 1 && j != pts - 1 && answer(dl, e)) dl->stats.witnessed++;
+    }
+    
+    /* x y ... u w becomes x u ... y w, missing the edges xy and uw */
+    
+    do {
+        moved = false;
+        for (i = 0; i < pts; i++) {
+            x = seq[i];
+            y = seq[(i + 1) % pts];
+            e = edgeIndex(dl->edges, dl->queries, x, y);
+            if (dl->result[e] == HC_SEARCH_CYCLE) continue;
+            
+            for (j = i + 2; j < i + pts - 1; j++) {
+                u = seq[j % pts];
+                w = seq[(j + 1) % pts];
+                if (!M[x][u] || !M[y][w]) continue;
+                
+                reversePath(seq, at, i + 1, j, pts);
+                if (answer(dl, e)) dl->stats.witnessed++;
+                e = edgeIndex(dl->edges, dl->queries, u, w);
+                if (answer(dl, e)) dl->stats.witnessed++;
+                moved = true;
+                break;
+            }
+        }
+    } while (moved);
+    
+} /* shareEdgeCycle */
+
+
+static void *
+deleteEdges(void *arg)
+{
+    HCDeleter      *w  = arg;
+    HCDeletion     *dl = w->shared;
+    Graph          *h  = w->graph;
+    UInt            pts = dl->pts;
+    Arc           **L  = h->adj_lists;
+    Arc            *a;
+    Vertex          x, y;
+    UInt            e;
+    bool            found;
+    double          seconds;
+    HCSearchStatus  r;
+    
+    while ((e = atomic_fetch_add(&dl->next, 1)) < dl->queries) {
+        
+        pthread_mutex_lock(&dl->lock);
+        if (dl->result[e] == HC_SEARCH_CYCLE) {
+            pthread_mutex_unlock(&dl->lock);
+            continue;
+        }
+        seconds = 0;
+        if (dl->deadline) {
+            seconds = dl->deadline - monotonicSeconds();
+            if (seconds <= 0) {
+                dl->result[e] = HC_SEARCH_UNDECIDED;
+                pthread_mutex_unlock(&dl->lock);
+                continue;
+            }
+        }
+        w->searching = dl->result + e;
+        dl->stats.searched++;
+        pthread_mutex_unlock(&dl->lock);
+        
+        /* g - e is the copy with both arcs of e unlinked */
+        
+        a = w->arcs[e];
+        x = a->cross->target;
+        y = a->target;
+        removeArc(L + x, a);
+        removeArc(L + y, a->cross);
+        h->degree[x]--;
+        h->degree[y]--;
+        
+        initHCState(w->hc, h->degree, L, dl->order);
+        setHCSearchLimits(w->hc, 0, seconds);
+        
+        found = dl->prune ? firstHamiltonianCycleWithPruning(w->hc)
+                          : firstHamiltonianCycle(w->hc);
+        r = getHCSearchStatus(w->hc);
+        
+        if (found) {
+            memset(w->cycle, 0, (2 * pts + 1) * sizeof(Vertex));
+            getCurrentHamiltonianCycle(w->hc, w->cycle);
+        }
+        
+        resetHCState(w->hc);
+        insertArc(L + x, a);
+        insertArc(L + y, a->cross);
+        h->degree[x]++;
+        h->degree[y]++;
+        
+        pthread_mutex_lock(&dl->lock);
+        w->searching = NULL;
+        if (found) {
+            if (answer(dl, e)) shareEdgeCycle(dl, w->cycle, w->cycle + pts);
+        } else if (dl->result[e] != HC_SEARCH_CYCLE) {
+            dl->result[e] = r;
+        }
+        pthread_mutex_unlock(&dl->lock);
+    }
+    
+    return NULL;
+    
+} /* deleteEdges */
+
+
+/*! The query of the pair x, y. */
+
+static inline UInt
+pairIndex(HCDeletion *dl, Vertex x, Vertex y)
+{
+    return x < y ? (x - 1) * dl->pts + y - 1 : (y - 1) * dl->pts + x - 1;
+} /* pairIndex */
+
+
+/*! Answer the pairs reached by rotating the far end of the Hamilton path
+(path[0] ... path[n-1]), queueing the rotated paths while the ring has 
+room.  Called with the lock held. */
+
+static void
+rotatePath(HCDeletion *dl, Vertex *path)
+{
+    Vertex  *r;
+    UInt     i, j;
+    
+    UInt     pts = dl->pts;
+    Vertex   t   = path[pts - 1];
+    bool   **M   = dl->graph->adj_matrix;
+    
+    for (i = 0; i + 2 < pts; i++) {
+        if (!M[t][path[i]]) continue;
+        if (!answer(dl, pairIndex(dl, path[0], path[i + 1]))) continue;
+        
+        dl->stats.witnessed++;
+        
+        if (dl->waiting == pts) continue;
+        
+        /* path[0] ... path[i] t ... path[i+1] */
+        
+        r = dl->ring + (dl->first + dl->waiting++) % pts * pts;
+        memcpy(r, path, (i + 1) * sizeof(Vertex));
+        for (j = i + 1; j < pts; j++) r[j] = path[pts + i - j];
+    }
+    
+} /* rotatePath */
+
+
+/*! Answer the pairs reached from the Hamilton path by rotations at either
+end, then from the paths those give, until none is waiting.  A pair 
+answered while the ring is full is not rotated further.  Called with the
+lock held. */
+
+static void
+sharePath(HCDeletion *dl, Vertex *path)
+{
+    Vertex  *p, t;
+    UInt     i, j;
+    
+    UInt     pts = dl->pts;
+    
+    memcpy(dl->ring + dl->first * pts, path, pts * sizeof(Vertex));
+    dl->waiting = 1;
+    
+    while (dl->waiting) {
+        p = dl->ring + dl->first * pts;
+        
+        rotatePath(dl, p);
+        for (i = 0, j = pts - 1; i < j; i++, j--) {
+            t    = p[i];
+            p[i] = p[j];
+            p[j] = t;
+        }
+        rotatePath(dl, p);
+        
+        dl->first = (dl->first + 1) % pts;
+        dl->waiting--;
+    }
+    
+} /* sharePath */
+
+
+static void *
+connectPairs(void *arg)
+{
+    HCDeleter      *w  = arg;
+    HCDeletion     *dl = w->shared;
+    Graph          *h  = w->graph;
+    UInt            pts = dl->pts;
+    Vertex          x, y;
+    UInt            q;
+    bool            found;
+    double          seconds;
+    HCSearchStatus  r;
+    
+    while ((q = atomic_fetch_add(&dl->next, 1)) < dl->queries) {
+        
+        x = q / pts + 1;
+        y = q % pts + 1;
+        if (x >= y) continue;
+        
+        pthread_mutex_lock(&dl->lock);
+        if (dl->result[q] == HC_SEARCH_CYCLE) {
+            pthread_mutex_unlock(&dl->lock);
+            continue;
+        }
+        seconds = 0;
+        if (dl->deadline) {
+            seconds = dl->deadline - monotonicSeconds();
+            if (seconds <= 0) {
+                dl->result[q] = HC_SEARCH_UNDECIDED;
+                pthread_mutex_unlock(&dl->lock);
+                continue;
+            }
+        }
+        w->searching = dl->result + q;
+        dl->stats.searched++;
+        pthread_mutex_unlock(&dl->lock);
+        
+        initHCPath(w->path, h->degree, h->adj_lists, x, y);
+        setHCSearchLimits(w->hc, 0, seconds);
+        
+        found = firstHamiltonianPath(w->path, dl->prune);
+        r     = getHCSearchStatus(w->hc);
+        
+        if (found) getCurrentHamiltonianPath(w->path, w->cycle);
+        resetHCPath(w->path);
+        
+        pthread_mutex_lock(&dl->lock);
+        w->searching = NULL;
+        if (found) {
+            if (answer(dl, q)) sharePath(dl, w->cycle);
+        } else if (dl->result[q] != HC_SEARCH_CYCLE) {
+            dl->result[q] = r;
+        }
+        pthread_mutex_unlock(&dl->lock);
+    }
+    
+    return NULL;
+    
+} /* connectPairs */
+
+
+/*! Allocate the private buffers of worker w, false if out of memory.  The
+state works on all of g for the edge queries, on n - 1 points for the
+vertex queries. */
+
+static bool
+allocateDeleter(HCDeletion *dl, HCDeleter *w, Status *st)
+{
+    Arc     *a;
+    Vertex   x;
+    
+    UInt     pts    = dl->pts;
+    UInt     points = dl->edges ? pts : pts - 1;
+    
+    w->shared    = dl;
+    w->searching = NULL;
+    
+    if (!(w->graph = copyGraph(dl->graph, st))) return false;
+    
+    if (dl->paths) {
+        if (!(w->path = allocateHCPath(pts, st))) return false;
+        w->hc = getHCPathState(w->path);
+        EM(w->cycle, (2 * pts + 1) * sizeof(Vertex), e0);
+        return true;
+    }
+    
+    w->hc    = allocateHCState(points, st);
+    w->order = allocateVArray(points, st);
+    CHECK_RETURN_VAL(*st, false);
+    
+    /* a state released without a search still needs a valid tape */
+    
+    initHCState(w->hc, w->graph->degree, w->graph->adj_lists, 
+                initVArray(w->order));
+    
+    EM(w->cycle, (2 * pts + 1) * sizeof(Vertex), e0);
+    
+    if (!dl->edges) {
+        EM(w->witness, 2 * (pts + 1) * sizeof(Vertex), e0);
+        EM(w->stack,   2 * pts * sizeof(Vertex),       e0);
+    }
+    
+    if (dl->edges) {
+        EM(w->arcs, dl->queries * sizeof(Arc *), e0);
+        for (x = 1; x <= (Vertex)pts; x++) {
+            for (a = w->graph->adj_lists[x]; a; a = a->next)
+                if (a->target > x) 
+                    w->arcs[edgeIndex(dl->edges, dl->queries, x, a->target)] = a;
+        }
+    }
+    
+    return true;
+    
+e0: *st = STATUS_NO_MEM;
+    return false;
+    
+} /* allocateDeleter */
+
+
+static void
+releaseDeleter(HCDeleter *w)
+{
+    free(w->arcs);
+    free(w->cycle);
+    free(w->witness);
+    free(w->stack);
+    if (w->order) releaseVArray(w->order);
+    if (w->path) releaseHCPath(w->path);
+    else if (w->hc) releaseHCState(w->hc);
+    if (w->graph) releaseGraph(w->graph);
+} /* releaseDeleter */
+
+
+/*! Set up dl for the queries on g, false if out of memory. */
+
+static bool
+initDeletion(HCDeletion *dl, Graph *g, UInt queries, bool prune, 
+             double seconds, HCSearchStatus *result, Status *status)
+{
+    memset(dl, 0, sizeof(HCDeletion));
+    
+    dl->graph    = g;
+    dl->pts      = g->vertex_count;
+    dl->prune    = prune;
+    dl->deadline = seconds > 0 ? monotonicSeconds() + seconds : 0;
+    dl->result   = result;
+    dl->queries  = queries;
+    atomic_store(&dl->next, 0);
+    
+    dl->order = allocateVArray(dl->pts, status);
+    CHECK_RETURN_VAL(*status, false);
+    sortVerticesDegreeDesc(initVArray(dl->order), g->degree);
+    
+    return true;
+    
+} /* initDeletion */
+
+
+/*! Run the queries of dl with work on threads workers, each with its own
+copy of the graph.  The caller does the work when no thread starts. */
+
+static void
+runDeletion(HCDeletion *dl, UInt threads, void *(*work)(void *), 
+            Status *status)
+{
+    UInt    i, made;
+    
+    if (!threads) threads = 1;
+    
+    EM(dl->workers, threads * sizeof(HCDeleter), e0);
+    memset(dl->workers, 0, threads * sizeof(HCDeleter));
+    
+    for (i = 0; i < threads; i++) 
+        if (!allocateDeleter(dl, dl->workers + i, status)) goto e1;
+    
+    dl->threads = threads;
+    pthread_mutex_init(&dl->lock, NULL);
+    
+    for (made = 0; made < threads; made++) {
+        if (pthread_create(&dl->workers[made].thread, NULL, work, 
+                           dl->workers + made)) break;
+    }
+    
+    if (!made) work(dl->workers);
+    for (i = 0; i < made; i++) pthread_join(dl->workers[i].thread, NULL);
+    
+    pthread_mutex_destroy(&dl->lock);
+    
+e1: for (i = 0; i < threads; i++) releaseDeleter(dl->workers + i);
+    free(dl->workers);
+    dl->workers = NULL;
+    dl->threads = 0;
+    return;
+    
+e0: *status = STATUS_NO_MEM;
+    
+} /* runDeletion */
+
+
+/*! The queries are handed out in vertex order, a worker skips those 
+already answered by a cycle exchange. */
+
+UInt
+decideVertexDeletedSubgraphs(Graph *g, UInt threads, bool prune, 
+                             double seconds, HCSearchStatus *result, 
+                             HCDeletionStatistics *st, Status *status)
+{
+    HCDeletion  dl;
+    Vertex      x;
+    UInt        count = 0;
+    
+    UInt        pts = g->vertex_count;
+    
+    memset(st, 0, sizeof(HCDeletionStatistics));
+    for (x = 0; x <= (Vertex)pts; x++) result[x] = HC_SEARCH_EXHAUSTED;
+    
+    CHECK_RETURN_VAL(*status, 0);
+    
+    /* g - v has fewer than 3 vertices */
+    
+    if (pts < 4) return 0;
+    
+    if (initDeletion(&dl, g, pts + 1, prune, seconds, result, status))
+        runDeletion(&dl, threads, deleteVertices, status);
+    if (dl.order) releaseVArray(dl.order);
+    
+    for (x = 1; x <= (Vertex)pts; x++) 
+        if (result[x] == HC_SEARCH_CYCLE) count++;
+    *st = dl.stats;
+    
+    return *status == STATUS_OK ? count : 0;
+    
+} /* decideVertexDeletedSubgraphs */
+
+
+/*! A cycle of g itself is searched first, the edge queries left open by
+it and its exchanges are then handed out in edge order. */
+
+UInt
+decideEdgeDeletedSubgraphs(Graph *g, UInt threads, bool prune, 
+                           double seconds, Vertex *edges, 
+                           HCSearchStatus *result, 
+                           HCDeletionStatistics *st, Status *status)
+{
+    HCDeletion  dl;
+    HCStateRef  hc;
+    Vertex     *cycle;
+    UInt        e, count = 0;
+    bool        found;
+    
+    UInt        pts = g->vertex_count;
+    UInt        m   = g->edge_count;
+    
+    memset(st, 0, sizeof(HCDeletionStatistics));
+    for (e = 0; e < m; e++) result[e] = HC_SEARCH_EXHAUSTED;
+    
+    CHECK_RETURN_VAL(*status, 0);
+    
+    if (!initDeletion(&dl, g, m, prune, seconds, result, status)) return 0;
+    
+    dl.edges = edges;
+    EM(dl.seq,   2 * (pts + 1) * sizeof(Vertex),     e0);
+    EM(cycle,    (2 * pts + 1) * sizeof(Vertex),     e1);
+    dl.at = dl.seq + pts + 1;
+    listEdges(g, edges);
+    
+    /* the search of g itself, on the caller's lists */
+    
+    /* without a state g has no cycle to lose, or memory ran out */
+
+    hc = pts < 3 ? NULL : allocateHCState(pts, status);
+    if (!hc) {
+        count = m;
+        goto e2;
+    }
+    initHCState(hc, g->degree, g->adj_lists, dl.order);
+    setHCSearchLimits(hc, 0, seconds);
+    
+    found = prune ? firstHamiltonianCycleWithPruning(hc)
+                  : firstHamiltonianCycle(hc);
+    dl.stats.searched++;
+    
+    if (found) {
+        memset(cycle, 0, (2 * pts + 1) * sizeof(Vertex));
+        getCurrentHamiltonianCycle(hc, cycle);
+        shareEdgeCycle(&dl, cycle, cycle + pts);
+    } else {
+        for (e = 0; e < m; e++) result[e] = getHCSearchStatus(hc);
+    }
+    releaseHCState(hc);
+    
+    if (found) runDeletion(&dl, threads, deleteEdges, status);
+    
+    for (e = 0; e < m; e++) if (result[e] == HC_SEARCH_EXHAUSTED) count++;
+    *st = dl.stats;
+    
+e2: free(cycle);
+    free(dl.seq);
+    releaseVArray(dl.order);
+    return *status == STATUS_OK ? count : 0;
+    
+e1: free(dl.seq);
+e0: releaseVArray(dl.order);
+    *status = STATUS_NO_MEM;
+    return 0;
+    
+} /* decideEdgeDeletedSubgraphs */
+
+
+/*! A path with free ends is searched first, then the pairs left open by
+its rotations are handed out in order. */
+
+UInt
+decideHamiltonianPaths(Graph *g, UInt threads, bool prune, double seconds,
+                       HCSearchStatus *result, HCDeletionStatistics *st, 
+                       Status *status)
+{
+    HCDeletion  dl;
+    HCPathRef   p;
+    Vertex     *path, x, y;
+    UInt        q, count = 0;
+    bool        found;
+    
+    UInt        pts = g->vertex_count;
+    
+    memset(st, 0, sizeof(HCDeletionStatistics));
+    for (q = 0; q < pts * pts; q++) result[q] = HC_SEARCH_EXHAUSTED;
+    
+    CHECK_RETURN_VAL(*status, 0);
+    
+    if (pts < 2) return 0;
+    
+    if (!initDeletion(&dl, g, pts * pts, prune, seconds, result, status))
+        return 0;
+    
+    dl.paths = true;
+    EM(path,    pts * sizeof(Vertex),       e0);
+    EM(dl.ring, pts * pts * sizeof(Vertex), e2);
+    
+    /* the search with free ends, on the caller's lists */
+    
+    if (!(p = allocateHCPath(pts, status))) goto e1;
+    initHCPath(p, g->degree, g->adj_lists, 0, 0);
+    setHCSearchLimits(getHCPathState(p), 0, seconds);
+    
+    found = firstHamiltonianPath(p, prune);
+    dl.stats.searched++;
+    
+    if (found) {
+        getCurrentHamiltonianPath(p, path);
+        answer(&dl, pairIndex(&dl, path[0], path[pts - 1]));
+        sharePath(&dl, path);
+    } else {
+        for (q = 0; q < pts * pts; q++) {
+            if (q / pts < q % pts) result[q] = getHCSearchStatus(
+                                                    getHCPathState(p));
+        }
+    }
+    releaseHCPath(p);
+    
+    if (found) runDeletion(&dl, threads, connectPairs, status);
+    
+    for (x = 1; x <= (Vertex)pts; x++) {
+        for (y = x + 1; y <= (Vertex)pts; y++) {
+            q = (x - 1) * pts + y - 1;
+            result[(y - 1) * pts + x - 1] = result[q];
+            if (result[q] == HC_SEARCH_CYCLE) count++;
+        }
+    }
+    *st = dl.stats;
+    
+e1: free(dl.ring);
+    free(path);
+    releaseVArray(dl.order);
+    return *status == STATUS_OK ? count : 0;
+    
+e2: free(path);
+e0: releaseVArray(dl.order);
+    *status = STATUS_NO_MEM;
+    return 0;
+    
+} /* decideHamiltonianPaths */
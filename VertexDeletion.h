@@ -0,0 +1,66 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#ifndef VERTEXDELETION_H
+#define VERTEXDELETION_H
+
+#include "Arch.h"
+#include "Graph.h"
+#include "HamiltonianCycle.h"
+
+/*! How the vertex or edge deleted subgraphs, or the vertex pairs, were 
+answered. */
+
+typedef struct hc_deletion_statistics {
+    UInt  searched;     /*!< subgraphs searched with the tape engine   */
+    UInt  witnessed;    /*!< answered by a cycle (path) of another one */
+} HCDeletionStatistics;
+
+/* decide for every vertex v of g whether g - v has a Hamilton cycle, on
+   threads threads sharing the queries.  result (n+1 entries) receives 
+   HC_SEARCH_CYCLE, HC_SEARCH_EXHAUSTED or HC_SEARCH_UNDECIDED for each 
+   vertex, a search stops after seconds (0 for no limit).  Returns the 
+   number of Hamiltonian subgraphs g - v. */
+UInt decideVertexDeletedSubgraphs(Graph *g, UInt threads, bool prune, 
+                                  double seconds, HCSearchStatus *result, 
+                                  HCDeletionStatistics *st, Status *status);
+
+/* decide for every edge e of g whether g - e has a Hamilton cycle, those
+   without one being the edges on every Hamilton cycle of g.  edges 
+   (2m entries) receives the ends of each edge, lower end first, ordered
+   by lower and then upper end; result (m entries) the answer for each 
+   edge as above.  Returns the number of edges on every Hamilton cycle, 
+   all m when g has none. */
+UInt decideEdgeDeletedSubgraphs(Graph *g, UInt threads, bool prune, 
+                                double seconds, Vertex *edges, 
+                                HCSearchStatus *result, 
+                                HCDeletionStatistics *st, Status *status);
+
+/* decide for every pair s < t of vertices of g whether g has a Hamilton
+   path from s to t.  result (n*n entries) receives the answer for s, t at
+   (s-1)*n + t-1 and at (t-1)*n + s-1, HC_SEARCH_EXHAUSTED on the 
+   diagonal.  Returns the number of pairs joined by a Hamilton path, 
+   n(n-1)/2 when g is Hamiltonian connected. */
+UInt decideHamiltonianPaths(Graph *g, UInt threads, bool prune, 
+                            double seconds, HCSearchStatus *result, 
+                            HCDeletionStatistics *st, Status *status);
+
+#endif /* VERTEXDELETION_H */
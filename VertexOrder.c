@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "Arch.h"
 #include "Graph.h"
+#include "Random.h"
 #include "VertexOrder.h"
 
 
@@ -123,3 +124,104 @@ sortVerticesDegreeDesc(VArray *va, UInt *d)
                 sizeof(Vertex), d, &vertex_compare_desc);
     return va;
 }
+
+
+/* reverse Cuthill-McKee ordering.
+
+ Vertices are visited breadth first from a minimum degree vertex of each
+ component, neighbours being queued in ascending degree order.  Reversing
+ the visit order gives a permutation with a small bandwidth so that
+ vertices adjacent in the graph receive nearby labels.
+
+ On return va->array[i] holds the vertex that is to be relabeled i+1.
+ 
+*/
+
+VArray *
+sortVerticesBandwidth(VArray *va, Graph *g, Status *st)
+{
+    Vertex  *q, *nb, *h, *t, x, y, z;
+    bool    *seen;
+    Arc     *a;
+    UInt     c, i;
+
+    UInt     pts = g->vertex_count;
+    UInt    *d   = g->degree;
+    
+    if (!va) return NULL;
+    
+    EM(seen, (pts + 1) * sizeof(bool),   e0);
+    EM(nb,   (pts + 1) * sizeof(Vertex), e1);
+    
+    memset(seen, false, (pts + 1) * sizeof(bool));
+    
+    q = h = t = va->array;
+    
+    while (t < q + pts) {
+    
+        /* start a new component from an unvisited minimum degree vertex */
+        
+        z = 0;
+        for (x = 1; x <= (Vertex)pts; x++) 
+            if (!seen[x] && (!z || d[x] < d[z])) z = x;
+            
+        seen[z] = true;
+        *t++    = z;
+        
+        while (h < t) {
+            
+            x = *h++;
+            c = 0;
+            
+            for (a = g->adj_lists[x]; a; a = a->next) {
+                y = a->target;
+                if (seen[y]) continue;
+                seen[y]  = true;
+                nb[c++]  = y;
+            }
+            
+            shell_sort(nb, c, sizeof(Vertex), d, &vertex_compare_asc);
+            
+            for (i = 0; i < c; i++) *t++ = nb[i];
+        }
+    }
+    
+    /* reverse */
+    
+    for (h = q, t = q + pts - 1; h < t; h++, t--) {
+        x  = *h;
+        *h = *t;
+        *t = x;
+    }
+    
+    free(nb);
+    free(seen);
+    return va;
+    
+e1: free(seen);
+e0: *st = STATUS_NO_MEM;
+    return NULL;
+    
+} /* sortVerticesBandwidth */
+
+
+/*! Fisher-Yates shuffle of the vertices in va. */
+
+VArray *
+shuffleVertices(VArray *va, RandomState *r)
+{
+    Vertex  t;
+    UInt    i, j;
+    
+    Vertex *a = va->array;
+    
+    for (i = va->length; i > 1; i--) {
+        j        = randomBelow(r, i);
+        t        = a[i-1];
+        a[i-1]   = a[j];
+        a[j]     = t;
+    }
+    
+    return va;
+    
+} /* shuffleVertices */
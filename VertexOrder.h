@@ -24,6 +24,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 VArray *sortVerticesDegreeAsc(VArray *va, UInt *deg);
 VArray *sortVerticesDegreeDesc(VArray *va, UInt *deg);
+VArray *sortVerticesBandwidth(VArray *va, Graph *g, Status *st);
+VArray *shuffleVertices(VArray *va, RandomState *r);
 
 #endif /* VERTEXORDER_H */
 
@@ -23,6 +23,14 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "GraphIO.h"
 #include "HamiltonianCycle.h"
 #include "VertexOrder.h"
+#include "GraphReduction.h"
+#include "GraphDecomposition.h"
+#include "GraphSymmetry.h"
+#include "VertexDeletion.h"
+#include "HamiltonianPath.h"
+#include "BitSearch.h"
+#include "PathDecomposition.h"
+#include "PortfolioSearch.h"
 
 #define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
 "This program is free software: you can redistribute it and/or modify\n"\
@@ -38,71 +46,553 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 "You should have received a copy of the GNU General Public License\n"\
 "along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
 
+/* restart schedule used by -R, run i may make RESTART_UNIT * luby(i) 
+   anchor rotations */
+
+#define RESTART_UNIT   100
+#define RESTART_COUNT  64
+
+/* default nogood table size for -n */
+
+#define NOGOOD_ENTRIES (1 << 20)
+
+/* default number of threads for -v and -e */
+
+#define DELETED_THREADS 4
+
 static void
 print_usage()
 {
 	puts(COPYRIGHT);
 	puts("This program outputs which graphs are hamiltonian "
 		" from the inputed graphs.\n");
-	puts("Usage: hc [-p] files...\n");
-    puts("Flags:\n\t-h\thelp\n\t-p\tUse pruning algorithm during search.\n");
+	puts("Usage: hc [-a] [-b] [-c] [-e[threads]] [-i<edges>] [-k] [-l[x-y]] "
+         "[-L[threads]] [-n[entries]] [-p] [-r] [-P] [-R[seed]] "
+         "[-t<seconds>] [-v[threads]] [-x<edges>] files...\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-a\tSearch one path from a start vertex per orbit of the\n"
+         "\t\tautomorphism group.\n"
+         "\t-b\tSearch small graphs with the tape engine only, without\n"
+         "\t\tswitching to a table of vertex subsets or a path\n"
+         "\t\tdecomposition.  The decomposition keeps at most 2^20\n"
+         "\t\tstates a step, about 110 MB.\n"
+         "\t-c\tSplit each graph along 2 vertex and 2 or 3 edge cuts and\n"
+         "\t\tdecide the pieces.\n"
+         "\t-e\tAlso find the edges on every Hamilton cycle, optional\n"
+         "\t\tnumber of threads following the flag (eg. -e8).\n"
+         "\t-i\tOnly look for cycles that use the given edges\n"
+         "\t\t(eg. -i1-2,5-9), not with -a, -c, -k or -P.\n"
+         "\t-k\tReduce each graph before searching, graphs the reductions\n"
+         "\t\tshow to be non-hamiltonian are not searched.\n"
+         "\t-l\tLook for a Hamilton path instead, from x to y when given\n"
+         "\t\t(eg. -l1-9, -l1 fixes one end only).\n"
+         "\t-L\tDecide for every pair of vertices whether a Hamilton path\n"
+         "\t\tjoins them, optional number of threads following the\n"
+         "\t\tflag (eg. -L8).\n"
+         "\t-n\tRemember the residual graphs of failed branches and skip\n"
+         "\t\tthem when met again, optional table size following the\n"
+         "\t\tflag (eg. -n4000000), not with -p.\n"
+         "\t-p\tUse pruning algorithm during search.\n"
+         "\t-r\tRelabel vertices for memory locality before searching.\n"
+         "\t-P\tRace several search configurations on separate threads\n"
+         "\t\tand report how often each one won.\n"
+         "\t-R\tRandomized restarts with a Luby schedule, seeded by the\n"
+         "\t\toptional number following the flag (eg. -R42).\n"
+         "\t-t\tGive up on a graph after the given number of seconds\n"
+         "\t\t(eg. -t60).\n"
+         "\t-v\tAlso decide every vertex deleted subgraph G - v, and\n"
+         "\t\twhether G is hypohamiltonian, optional number of threads\n"
+         "\t\tfollowing the flag (eg. -v8).\n"
+         "\t-x\tOnly look for cycles that avoid the given edges\n"
+         "\t\t(eg. -x3-4), not with -a, -c, -k or -P.\n");
+    
+}
+
+static void
+print_portfolio_stats(HCPortfolioRef p)
+{
+    HCPortfolioStats st;
+    UInt             i;
+    
+    printf("\nPortfolio results:\n");
+    for (i = 0; i < getPortfolioSize(p); i++) {
+        getPortfolioStatistics(p, i, &st);
+        printf("  %-12s %8" c_PF_ULongLong " wins %12.3f s\n",
+                getPortfolioConfig(p, i)->name, st.wins, st.seconds);
+    }
+}
+
+/*! Decide the subgraphs g - v, true when all of them are Hamiltonian. */
+
+static bool
+print_deleted(Graph *g, UInt threads, bool prune, double seconds, 
+              Status *s)
+{
+    HCSearchStatus      *result;
+    HCDeletionStatistics st;
+    Vertex               x;
+    UInt                 c, open = 0;
+    bool                 first = true;
+    
+    UInt                 pts   = g->vertex_count;
+    
+    if (!(result = malloc((pts + 1) * sizeof(HCSearchStatus)))) return false;
+    
+    c = decideVertexDeletedSubgraphs(g, threads, prune, seconds, result, 
+                                     &st, s);
+    
+    for (x = 1; x <= pts; x++) if (result[x] == HC_SEARCH_UNDECIDED) open++;
+    
+    printf("%s: %u of %u vertex deleted subgraphs are Hamiltonian", 
+           g->name, c, pts);
+    if (open) printf(", %u undecided", open);
+    printf(" (%u searched, %u from other cycles).\n", 
+           st.searched, st.witnessed);
+    
+    for (x = 1; x <= pts; x++) {
+        if (result[x] != HC_SEARCH_EXHAUSTED) continue;
+        printf(first ? "\tnot Hamiltonian without %d" : " %d", x);
+        first = false;
+    }
+    if (!first) printf("\n");
+    
+    free(result);
+    return c == pts;
+}
+
+/*! List the edges of g on every Hamilton cycle. */
+
+static void
+print_essential(Graph *g, UInt threads, bool prune, double seconds, 
+                Status *s)
+{
+    HCSearchStatus      *result;
+    HCDeletionStatistics st;
+    Vertex              *edges;
+    UInt                 c, e, open = 0;
+    bool                 first = true;
+    
+    UInt                 m = g->edge_count;
+    
+    if (!(edges = malloc(2 * m * sizeof(Vertex) + 
+                         m * sizeof(HCSearchStatus)))) return;
+    result = (HCSearchStatus *)(edges + 2 * m);
+    
+    c = decideEdgeDeletedSubgraphs(g, threads, prune, seconds, edges, 
+                                   result, &st, s);
+    
+    /* only the search of g itself ran and found no cycle, or none ran
+       on fewer than 3 vertices */
+    
+    if (st.searched <= 1 && c == m) {
+        free(edges);
+        return;
+    }
+    
+    for (e = 0; e < m; e++) if (result[e] == HC_SEARCH_UNDECIDED) open++;
+    
+    printf("%s: %u of %u edges are on every Hamilton cycle", 
+           g->name, c, m);
+    if (open) printf(", %u undecided", open);
+    printf(" (%u searched, %u from other cycles).\n", 
+           st.searched, st.witnessed);
+    
+    for (e = 0; e < m; e++) {
+        if (result[e] != HC_SEARCH_EXHAUSTED) continue;
+        printf(first ? "\ton every cycle %d-%d" : " %d-%d", 
+               edges[2 * e], edges[2 * e + 1]);
+        first = false;
+    }
+    if (!first) printf("\n");
+    
+    free(edges);
+}
+
+/*! Decide the Hamilton paths between every pair of vertices of g. */
+
+static void
+print_paths(Graph *g, UInt threads, bool prune, double seconds, Status *s)
+{
+    HCSearchStatus      *result;
+    HCDeletionStatistics st;
+    Vertex               x, y;
+    UInt                 c, open = 0;
+    bool                 first = true;
+    
+    UInt                 pts   = g->vertex_count;
+    UInt                 pairs = pts * (pts - 1) / 2;
+    
+    if (!(result = malloc(pts * pts * sizeof(HCSearchStatus)))) return;
+    
+    c = decideHamiltonianPaths(g, threads, prune, seconds, result, &st, s);
+    
+    for (x = 1; x <= pts; x++) {
+        for (y = x + 1; y <= pts; y++) 
+            if (result[(x - 1) * pts + y - 1] == HC_SEARCH_UNDECIDED) open++;
+    }
+    
+    printf("%s: %u of %u vertex pairs are joined by a Hamilton path", 
+           g->name, c, pairs);
+    if (open) printf(", %u undecided", open);
+    printf(" (%u searched, %u from other paths).\n", 
+           st.searched, st.witnessed);
+    
+    for (x = 1; x <= pts; x++) {
+        for (y = x + 1; y <= pts; y++) {
+            if (result[(x - 1) * pts + y - 1] != HC_SEARCH_EXHAUSTED) continue;
+            printf(first ? "\tno Hamilton path %d-%d" : " %d-%d", x, y);
+            first = false;
+        }
+    }
+    if (!first) printf("\n");
+    if (c == pairs) printf("%s is Hamiltonian connected.\n", g->name);
+    
+    free(result);
+}
+
+/*! Look for a Hamilton path of g from x to y, 0 leaving an end free. */
+
+static void
+print_path(Graph *g, Vertex x, Vertex y, bool prune, double seconds, 
+           Status *s)
+{
+    HCPathRef   p;
+    
+    if (!(p = allocateHCPath(g->vertex_count, s))) return;
     
+    initHCPath(p, g->degree, g->adj_lists, x, y);
+    setHCSearchLimits(getHCPathState(p), 0, seconds);
+    
+    if (firstHamiltonianPath(p, prune))
+        printf("%s has a Hamilton path.\n", g->name);
+    else if (getHCSearchStatus(getHCPathState(p)) == HC_SEARCH_UNDECIDED)
+        printf("%s is undecided (time limit reached).\n", g->name);
+    
+    releaseHCPath(p);
+}
+
+/*! Read a list of edges x-y separated by commas into x,y pairs, the 
+number of edges is stored in *count. */
+
+static Vertex *
+parse_edges(char *arg, UInt *count)
+{
+    Vertex  *edges;
+    char    *p;
+    UInt     c = 1;
+    
+    for (p = arg; *p; p++) if (*p == ',') c++;
+    if (!(edges = malloc(2 * c * sizeof(Vertex)))) return NULL;
+    
+    for (c = 0, p = arg; *p; c++) {
+        edges[2 * c]     = strtoul(p, &p, 10);
+        if (*p == '-') p++;
+        edges[2 * c + 1] = strtoul(p, &p, 10);
+        if (*p == ',') p++;
+        else if (*p) break;
+    }
+    
+    *count = c;
+    return edges;
+}
+
+/*! Map the edges of the input graph onto the graph relabeled by lb. */
+
+static void
+relabel_edges(Vertex *from, UInt count, VArray *lb, Vertex *to)
+{
+    UInt     i;
+    Vertex   x;
+    
+    for (i = 0; i < 2 * count; i++) {
+        to[i] = 0;
+        for (x = 0; x < lb->length; x++) {
+            if (lb->array[x] == from[i]) to[i] = x + 1;
+        }
+    }
 }
 
 int main(int argc, char ** argv)
 {
-    Graph *g;
+    Graph *g, *h;
     GraphIteratorRef i;
     HCStateRef hc;
-    VArray *vo;
+    HCPortfolioRef pf = NULL;
+    HCKernelRef kr = NULL;
+    HCDecompositionRef dc = NULL;
+    HCSymmetryRef sy = NULL;
+    VArray *vo, *lb;
+    Vertex *req = NULL, *forb = NULL, *rlb = NULL, *flb = NULL;
+    UInt    nreq = 0, nforb = 0;
+    Vertex  from = 0, to = 0;
+    bool    path = false;
+    UInt    pairs = 0;
+    char   *end;
     Status  stat = STATUS_OK;
     StatusRef  s = &stat;
     UInt    pts; 
     UInt    t;
     bool    prune = 0;
+    bool    relabel = 0;
+    bool    portfolio = 0;
+    bool    restart = 0;
+    UInt    nogoods = 0;
+    UInt    deleted = 0;
+    UInt    essential = 0;
+    bool    hypo    = false;
+    bool    tables  = true;
+    bool    chosen;
+    double  cost;
+    ULongLong seed = 1;
+    double  seconds = 0;
+    HCSearchStatus found;
   
     if (argc == 1) { 
         print_usage();
         exit(0);
     }   
-    /* first scan arguments for -h or -p flags */
+    /* first scan arguments for flags */
     for (t = 0; t < argc; t++) {
         if (argv[t][0] == '-' && argv[t][1]){
-            if (argv[t][1]=='h'){ 
+            switch (argv[t][1]) {
+            case 'h':
                 print_usage();
                 exit(0);
+            case 'a':
+                sy = allocateSymmetry(s);
+                break;
+            case 'b':
+                tables = false;
+                break;
+            case 'c':
+                dc = allocateDecomposition(s);
+                break;
+            case 'i':
+                req = parse_edges(argv[t] + 2, &nreq);
+                break;
+            case 'k':
+                kr = allocateKernel(s);
+                break;
+            case 'l':
+                path = true;
+                from = strtoul(argv[t] + 2, &end, 10);
+                if (*end == '-') to = strtoul(end + 1, NULL, 10);
+                break;
+            case 'L':
+                pairs = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                   : DELETED_THREADS;
+                break;
+            case 'n':
+                nogoods = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                     : NOGOOD_ENTRIES;
+                break;
+            case 'p':
+                prune = true;
+                break;
+            case 'r':
+                relabel = true;
+                break;
+            case 'P':
+                portfolio = true;
+                break;
+            case 'R':
+                restart = true;
+                if (argv[t][2]) seed = strtoull(argv[t] + 2, NULL, 10);
+                break;
+            case 't':
+                seconds = atof(argv[t] + 2);
+                break;
+            case 'e':
+                essential = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                       : DELETED_THREADS;
+                break;
+            case 'v':
+                deleted = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                     : DELETED_THREADS;
+                break;
+            case 'x':
+                forb = parse_edges(argv[t] + 2, &nforb);
+                break;
             }
-            prune = argv[t][1] == 'p';
         }
     }
 
+    if ((nreq || nforb) && (kr || dc || sy || portfolio)) {
+        fprintf(stderr, "hc: -i and -x search the graph as given, "
+                        "they cannot be used with -a, -c, -k or -P\n");
+        exit(1);
+    }
+    
+    if (nogoods && prune) {
+        fprintf(stderr, "hc: the nogood search of -n does not prune, "
+                        "it cannot be used with -p\n");
+        exit(1);
+    }
+    
+    if (relabel) {
+        rlb = req  ? malloc(2 * nreq  * sizeof(Vertex)) : NULL;
+        flb = forb ? malloc(2 * nforb * sizeof(Vertex)) : NULL;
+    }
+    
+    if (portfolio) pf = initPortfolio(
+                allocatePortfolio(HC_PORTFOLIO_DEFAULT_SIZE, s), NULL);
+    
     i = allocateGraphIterator(s);
     initGraphIteratorWithFiles(i,argc - 1 , ++argv);
     
     while ( loadNextGraph(i, &g, s) ){
         
+        /* paths are searched on the graph as given */
+        
+        if (path || pairs) {
+            if (pairs) print_paths(g, pairs, prune, seconds, s);
+            else print_path(g, from, to, prune, seconds, s);
+            releaseGraph(g);
+            continue;
+        }
+        
+        if (kr) {
+            
+            /* search the reduced graph, it has as many cycles as g */
+            
+            if (reduceGraph(kr, g, s) == HC_KERNEL_NO_CYCLE) {
+                releaseGraph(g);
+                continue;
+            }
+            h = copyGraph(getKernelGraph(kr), s);
+            releaseGraph(g);
+            g = h;
+        }
+        
         pts = g->vertex_count;
+        lb  = NULL;
+        
+        if (deleted) hypo = print_deleted(g, deleted, prune, seconds, s);
+        if (essential) print_essential(g, essential, prune, seconds, s);
+        
+        if (relabel) {
+            
+            /* renumber vertices so that neighbours are stored close
+               to each other */
+            
+            lb = sortVerticesBandwidth(
+                    initVArray(allocateVArray(pts, s)), g, s);
+            h  = relabelGraph(g, lb, s);
+            releaseGraph(g);
+            g  = h;
+        }
+        
+        if (dc || sy) {
+            if (sy) {
+                initSymmetry(sy, prune, seconds);
+                found = decideBySymmetry(sy, g, s);
+            } else {
+                initDecomposition(dc, prune, seconds);
+                found = decideByDecomposition(dc, g, s);
+            }
+            if (found == HC_SEARCH_CYCLE)
+                printf("%s is Hamiltonian.\n", g->name);
+            else if (found == HC_SEARCH_UNDECIDED)
+                printf("%s is undecided (time limit reached).\n", g->name);
+            if (lb) releaseVArray(lb);
+            releaseGraph(g);
+            continue;
+        }
+        
+        if (pf) {
+            if (runPortfolio(pf, g, s) == HC_SEARCH_CYCLE)
+                printf("%s is Hamiltonian.\n", g->name);
+            if (lb) releaseVArray(lb);
+            releaseGraph(g);
+            continue;
+        }
+        
+        /* graphs of small width go to the path decomposition, and other
+           small graphs to the subset table, once the tape engine has run
+           as long as they would take */
+        
+        chosen = tables && !lb && !nreq && !nforb && !nogoods && !restart;
+        
+        if (chosen) {
+            cost = pathDecompositionCost(g, s);
+            if (cost <= HC_PATH_AUTO_COST && 
+                (pts > HC_BITS_DECIDE_TABLE || 
+                 cost < (double)((ULongLong)1 << pts) * pts / 2)) {
+                found = decideByTapeThenPaths(g, prune, seconds, s);
+            } else if (pts <= HC_BITS_DECIDE_TABLE) {
+                found = decideBySubsets(g, prune, seconds, s);
+            } else chosen = false;
+        }
+        
+        if (chosen) {
+            if (found == HC_SEARCH_CYCLE)
+                printf("%s is Hamiltonian.\n", g->name);
+            else if (found == HC_SEARCH_UNDECIDED)
+                printf("%s is undecided (time limit reached).\n", g->name);
+            else if (deleted && hypo)
+                printf("%s is hypohamiltonian.\n", g->name);
+            releaseGraph(g);
+            continue;
+        }
+        
         vo  = sortVerticesDegreeDesc( 
                     initVArray(allocateVArray(pts, s)), g->degree);
         
         hc = initHCState(allocateHCState(g->vertex_count, s),
                          g->degree, g->adj_lists, vo);
+        setHCSearchLimits(hc, 0, seconds);
         
-        if (prune) {
-            if (firstHamiltonianCycle(hc)){
+        if (lb) {
+            if (rlb) relabel_edges(req,  nreq,  lb, rlb);
+            if (flb) relabel_edges(forb, nforb, lb, flb);
+            setHCEdgeConstraints(hc, rlb, rlb ? nreq : 0, 
+                                 flb, flb ? nforb : 0);
+        } else setHCEdgeConstraints(hc, req, nreq, forb, nforb);
+        
+        if (nogoods) {
+            if (firstHamiltonianCycleWithNogoods(hc, nogoods)){
                 printf("%s is Hamiltonian.\n", g->name);
             }
-        } else {
+        } else if (restart) {
+            if (firstHamiltonianCycleWithRestarts(hc, seed, RESTART_UNIT,
+                                                  RESTART_COUNT, prune)){
+                printf("%s is Hamiltonian.\n", g->name);
+            }
+        } else if (prune) {
             if (firstHamiltonianCycleWithPruning(hc)){
                 printf("%s is Hamiltonian.\n", g->name);
+            }
+        } else {
+            if (firstHamiltonianCycle(hc)){
+                printf("%s is Hamiltonian.\n", g->name);
             }            
         }
+        
+        if (getHCSearchStatus(hc) == HC_SEARCH_UNDECIDED)
+            printf("%s is undecided (time limit reached).\n", g->name);
+        else if (deleted && hypo && 
+                 getHCSearchStatus(hc) == HC_SEARCH_EXHAUSTED)
+            printf("%s is hypohamiltonian.\n", g->name);
+        
         releaseHCState(hc);
         releaseVArray(vo);
+        if (lb) releaseVArray(lb);
         releaseGraph(g);
     }
     
     releaseGraphIterator(i);
+    free(req);
+    free(forb);
+    free(rlb);
+    free(flb);
+    releaseKernel(kr);
+    releaseDecomposition(dc);
+    releaseSymmetry(sy);
+    
+    if (pf) {
+        print_portfolio_stats(pf);
+        releasePortfolio(pf);
+    }
     return 0;
 }
 
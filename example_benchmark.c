@@ -0,0 +1,269 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "Graph.h"
+#include "GraphIO.h"
+#include "GraphGenerators.h"
+#include "HamiltonianCycle.h"
+#include "VertexOrder.h"
+#include "Random.h"
+#include "Timer.h"
+
+#define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
+"This program is free software: you can redistribute it and/or modify\n"\
+"it under the terms of the GNU General Public License as published by\n"\
+"the Free Software Foundation, either version 3 of the License, or\n"\
+"(at your option) any later version.\n"\
+"\n"\
+"This program is distributed in the hope that it will be useful,\n"\
+"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"\
+"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"\
+"GNU General Public License for more details.\n"\
+"\n"\
+"You should have received a copy of the GNU General Public License\n"\
+"along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
+
+/* defaults for the number of runs of each engine on a graph, the time 
+   limit of one run and the seed of the random families, and the memo
+   table size of the memoizing count */
+
+#define BENCH_REPEATS  3
+#define BENCH_SECONDS  30.0
+#define BENCH_SEED     20090101ULL
+#define BENCH_MEMO     (1 << 20)
+
+/*! One graph of the built in suite, a and b are family parameters. */
+
+typedef struct bench_case {
+    char   *family;
+    UInt    a, b;
+    double  radius;
+} BenchCase;
+
+static BenchCase suite[] = {
+    { "gp",        20, 3, 0   },
+    { "gp",        30, 7, 0   },
+    { "hypo",       5, 0, 0   },   /* GP(35,2) */
+    { "hypo",       6, 0, 0   },   /* GP(41,2) */
+    { "hypo",       7, 0, 0   },   /* GP(47,2) */
+    { "hypo",       8, 0, 0   },   /* GP(53,2) */
+    { "regular",   60, 3, 0   },
+    { "regular",   80, 3, 0   },
+    { "regular",   24, 4, 0   },
+    { "regular",   18, 5, 0   },
+    { "grid",       6, 6, 0   },
+    { "grid",       6, 8, 0   },
+    { "moebius",   20, 0, 0   },
+    { "moebius",  100, 0, 0   },
+    { "geometric", 16, 0, 0.45},
+    { "geometric", 20, 0, 0.39},
+    { NULL,         0, 0, 0   }
+};
+
+/*! A way of running the search, a decision or a count. */
+
+typedef struct bench_engine {
+    char   *name;
+    bool    count;
+    bool    prune;
+    bool    memo;
+} BenchEngine;
+
+static BenchEngine engines[] = {
+    { "hc",             false, false, false },
+    { "hc-prune",       false, true,  false },
+    { "hc-nogoods",     false, false, true  },
+    { "hc_count",       true,  false, false },
+    { "hc_count-prune", true,  true,  false },
+    { "hc_count-memo",  true,  false, true  },
+    { NULL,             false, false, false }
+};
+
+static void
+print_usage()
+{
+	puts(COPYRIGHT);
+	puts("This program times the search engines on a suite of generated "
+        "graphs,\nor on the graphs of the given files, and writes one line "
+        "per run.\n");
+	puts("Usage: hc_bench [-c] [-n<runs>] [-S<seed>] [-t<seconds>] "
+         "[files...]\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-c\tWrite comma separated values instead of tab separated.\n"
+         "\t-n\tRuns of each engine on each graph (eg. -n5).\n"
+         "\t-S\tSeed of the random graph families (eg. -S42).\n"
+         "\t-t\tTime limit of a single run in seconds (eg. -t60).\n");
+}
+
+/*! Time every engine repeats times on g and write a line per run.  Each
+run searches its own copy of g, the search leaves the arc lists in a 
+different order and that order changes the work done. */
+
+static void
+bench_graph(Graph *g, char *family, UInt repeats, double seconds, char sep,
+            Status *s)
+{
+    HCStateRef      hc;
+    Graph          *h;
+    VArray         *vo;
+    BenchEngine    *en;
+    HCStatistics    st;
+    HCSearchStatus  result;
+    ULongLong       c;
+    double          t;
+    UInt            run;
+    bool            found;
+    char            prunes[24];
+    
+    char           *q = sep == ',' ? "\"" : "";
+    
+    for (en = engines; en->name; en++) {
+        for (run = 1; run <= repeats; run++) {
+        
+            if (!(h = copyGraph(g, s))) return;
+            
+            vo = sortVerticesDegreeDesc(
+                    initVArray(allocateVArray(h->vertex_count, s)), 
+                    h->degree);
+            hc = allocateHCState(h->vertex_count, s);
+            if (*s != STATUS_OK) {
+                if (vo) releaseVArray(vo);
+                releaseGraph(h);
+                return;
+            }
+            
+            initHCState(hc, h->degree, h->adj_lists, vo);
+            setHCSearchLimits(hc, 0, seconds);
+            
+            c = 0;
+            t = monotonicSeconds();
+            
+            if (en->memo && en->count) {
+                c     = countHamiltonianCycles(hc, BENCH_MEMO);
+                found = false;
+            } else if (en->memo) {
+                found = firstHamiltonianCycleWithNogoods(hc, BENCH_MEMO);
+                c     = found;
+            } else {
+                found = en->prune ? firstHamiltonianCycleWithPruning(hc)
+                                  : firstHamiltonianCycle(hc);
+                if (found) c++;
+            }
+            
+            if (en->count && found) {
+                while (en->prune ? nextHamiltonianCycleWithPruning(hc)
+                                 : nextHamiltonianCycle(hc)) c++;
+            }
+            
+            t      = monotonicSeconds() - t;
+            result = getHCSearchStatus(hc);
+            getHCStatistics(hc, &st);
+            
+            /* prunes are only counted by the statistics build */
+            
+            if (st.enabled) 
+                sprintf(prunes, "%" c_PF_ULongLong, st.prunes);
+            else 
+                strcpy(prunes, "n/a");
+            
+            /* graph titles may hold commas, quote them in csv output */
+            
+            printf("%s%c%s%s%s%c%u%c%u%c%s%c%u%c%s%c%" c_PF_ULongLong 
+                   "%c%" c_PF_ULongLong "%c%s%c%.6f\n",
+                   family, sep, q, g->name, q, sep, g->vertex_count, sep, 
+                   g->edge_count, sep, en->name, sep, run, sep,
+                   result == HC_SEARCH_UNDECIDED ? "timeout" 
+                    : (c ? "hamiltonian" : "non-hamiltonian"),
+                   sep, c, sep, st.rotations, sep, prunes, sep, t);
+            fflush(stdout);
+            
+            releaseHCState(hc);
+            releaseVArray(vo);
+            releaseGraph(h);
+        }
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    Graph *g;
+    GraphIteratorRef i;
+    BenchCase *bc;
+    Status  stat = STATUS_OK;
+    StatusRef  s = &stat;
+    UInt    t;
+    UInt    files   = 0;
+    UInt    repeats = BENCH_REPEATS;
+    double  seconds = BENCH_SECONDS;
+    ULongLong seed  = BENCH_SEED;
+    char    sep     = '\t';
+    
+    /* first scan arguments for flags */
+    for (t = 1; t < argc; t++) {
+        if (argv[t][0] == '-' && argv[t][1]){
+            switch (argv[t][1]) {
+            case 'h':
+                print_usage();
+                exit(0);
+            case 'c':
+                sep = ',';
+                break;
+            case 'n':
+                repeats = atoi(argv[t] + 2);
+                break;
+            case 'S':
+                seed = strtoull(argv[t] + 2, NULL, 10);
+                break;
+            case 't':
+                seconds = atof(argv[t] + 2);
+                break;
+            }
+        } else files++;
+    }
+    
+    printf("family%cgraph%cvertices%cedges%cengine%crun%cresult%ccycles"
+           "%crotations%cprunes%cseconds\n", 
+           sep, sep, sep, sep, sep, sep, sep, sep, sep, sep);
+    
+    if (files) {
+        i = allocateGraphIterator(s);
+        initGraphIteratorWithFiles(i, argc - 1, ++argv);
+        
+        while (loadNextGraph(i, &g, s)) {
+            bench_graph(g, "file", repeats, seconds, sep, s);
+            releaseGraph(g);
+        }
+        
+        releaseGraphIterator(i);
+        return stat != STATUS_OK;
+    }
+    
+    for (bc = suite; bc->family && stat == STATUS_OK; bc++) {
+        g = generateGraph(bc->family, bc->a, bc->b, bc->radius, seed, s);
+        if (!g) break;
+        bench_graph(g, bc->family, repeats, seconds, sep, s);
+        releaseGraph(g);
+    }
+    
+    return stat != STATUS_OK;
+}
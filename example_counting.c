@@ -19,10 +19,39 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 
 #include <stdlib.h>
+#include <signal.h>
 #include "Graph.h"
 #include "GraphIO.h"
+#include "ArchIO.h"
 #include "HamiltonianCycle.h"
 #include "VertexOrder.h"
+#include "GraphReduction.h"
+#include "GraphDecomposition.h"
+#include "GraphSymmetry.h"
+#include "HamiltonianPath.h"
+#include "BitSearch.h"
+#include "InclusionExclusion.h"
+#include "PathDecomposition.h"
+#include "Timer.h"
+
+/* anchor rotations run between checks for a progress report */
+
+#define PROGRESS_STEP 4096
+
+/* default number of memo table entries for -m */
+
+#define MEMO_ENTRIES    (1 << 20)
+
+/* default number of probes for -e, and the seed they are drawn with */
+
+#define ESTIMATE_PROBES 10000
+#define ESTIMATE_SEED   1
+
+/* default number of threads summing over vertex subsets */
+
+#define INCLUSION_THREADS 4
+
+static volatile sig_atomic_t report_requested = 0;
 
 
 #define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
@@ -45,62 +74,549 @@ print_usage()
 	puts(COPYRIGHT);
 	puts("This program outputs the hamiltonian cycle counts found"
 		" for each of the the inputed graphs.\n");
-	puts("Usage: hc [-p] files...\n");
-    puts("Flags:\n\t-h\thelp\n\t-p\tUse pruning algorithm during search.\n");
+	puts("Usage: hc [-a] [-b] [-c] [-d<file>] [-e[probes]] [-i<seconds>] [-I[threads]] [-k] [-l[x-y]] [-m[entries]]"
+         " [-p] [-r] [-s] [-t<seconds>] [-u] files...\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-a\tCount one path from a start vertex per orbit of the\n"
+         "\t\tautomorphism group and weigh it by the orbit size.\n"
+         "\t-b\tCount small graphs with the tape engine only, without\n"
+         "\t\tswitching to a table or a sum over vertex subsets, or\n"
+         "\t\tto a path decomposition.  The decomposition keeps at\n"
+         "\t\tmost 2^20 states a step, about 110 MB.\n"
+         "\t-c\tSplit each graph along 2 vertex and 2 or 3 edge cuts and\n"
+         "\t\tcombine the counts of the pieces.\n"
+         "\t-d\tWrite the tape event trace to the given file with each\n"
+         "\t\tprogress report and when the time limit is reached (eg.\n"
+         "\t\t-dtrace.txt, build with 'make trace').\n"
+         "\t-e\tEstimate the cycle count and search tree size from random\n"
+         "\t\tprobes instead of counting, optional number of probes\n"
+         "\t\tfollowing the flag (eg. -e100000).\n"
+         "\t-i\tReport progress on stderr every given number of seconds\n"
+         "\t\t(eg. -i600).  A report is also made on SIGUSR1.\n"
+         "\t-I\tCount by inclusion-exclusion over the vertex subsets,\n"
+         "\t\toptional number of threads following the flag (eg. -I8).\n"
+         "\t-k\tReduce each graph before searching, graphs the reductions\n"
+         "\t\tshow to be non-hamiltonian are not searched.\n"
+         "\t-l\tCount the Hamilton paths instead, those from x to y when\n"
+         "\t\tgiven (eg. -l1-9, -l1 fixes one end only).\n"
+         "\t-m\tCount with a table of the counts of residual graphs,\n"
+         "\t\tsearching each residual graph once.  Optional number of\n"
+         "\t\ttable entries following the flag (eg. -m4000000), not\n"
+         "\t\twith -p.\n"
+         "\t-p\tUse pruning algorithm during search.\n"
+         "\t-r\tRelabel vertices for memory locality before searching.\n"
+         "\t-s\tPrint search statistics for each graph (build with\n"
+         "\t\t'make stats' for the full set of counters).\n"
+         "\t-t\tStop counting a graph after the given number of seconds\n"
+         "\t\t(eg. -t60).\n"
+         "\t-u\tAlso count the cycles through each edge (of the reduced\n"
+         "\t\tgraph with -k).\n");
+    
+}
+
+static void
+print_huge_count(char *name, UHugeInt c, bool partial)
+{
+    char buf[MAX_UHugeInt_STR_LEN + 1];
+    
+    buf[write_usignedhugeval_str(buf, c)] = '\0';
+    
+    if (partial)
+        printf("%s has at least %s Hamiltonian Cycles (time limit "
+               "reached).\n", name, buf);
+    else
+        printf("%s has %s Hamiltonian Cycles.\n", name, buf);
+}
+
+static void
+print_path_count(Graph *g, Vertex x, Vertex y, bool prune, double seconds,
+                 Status *s)
+{
+    HCPathRef   p;
+    ULongLong   c = 0;
+    
+    if (!(p = allocateHCPath(g->vertex_count, s))) return;
+    
+    initHCPath(p, g->degree, g->adj_lists, x, y);
+    setHCSearchLimits(getHCPathState(p), 0, seconds);
+    
+    if (firstHamiltonianPath(p, prune)) {
+        do c++; while (nextHamiltonianPath(p, prune));
+    }
+    
+    if (getHCSearchStatus(getHCPathState(p)) == HC_SEARCH_UNDECIDED)
+        printf("%s has at least %" c_PF_ULongLong 
+               " Hamiltonian Paths (time limit reached).\n", g->name, c);
+    else
+        printf("%s has %" c_PF_ULongLong " Hamiltonian Paths.\n", 
+               g->name, c);
+    
+    releaseHCPath(p);
+}
+
+static void
+print_statistics(HCStateRef hc)
+{
+    HCStatistics st;
+    
+    getHCStatistics(hc, &st);
+    
+    printf("\trotations   %" c_PF_ULongLong "\n", st.rotations);
+    if (st.memoHits + st.memoMisses) {
+        printf("\tmemo hits   %" c_PF_ULongLong "\n", st.memoHits);
+        printf("\tmemo misses %" c_PF_ULongLong "\n", st.memoMisses);
+        printf("\tevictions   %" c_PF_ULongLong "\n", st.memoEvictions);
+    }
+    if (!st.enabled) return;
+    
+    printf("\tanchors     %" c_PF_ULongLong "\n", st.anchors);
+    printf("\textensions  %" c_PF_ULongLong "\n", st.extensions);
+    printf("\tunwinds     %" c_PF_ULongLong "\n", st.unwinds);
+    printf("\tprunes      %" c_PF_ULongLong "\n", st.prunes);
+    printf("\tforced      %" c_PF_ULongLong "\n", st.forced);
+    printf("\tforced deg2 %" c_PF_ULongLong "\n", st.forcedDeg2);
+    printf("\tmax depth   %" c_PF_UInt "\n", st.maxDepth);
+    
+}
+
+static void
+print_kernel(HCKernelRef kr, Graph *g)
+{
+    HCKernelStatistics st;
+    
+    getKernelStatistics(kr, &st);
+    
+    printf("\tkernel      %u vertices, %u edges, %u edges removed, "
+           "%u vertices contracted\n", g->vertex_count, g->edge_count,
+           st.removedEdges, st.contracted);
+}
+
+static void
+print_decomposition(HCDecompositionRef dc)
+{
+    HCDecompositionStatistics st;
+    
+    getDecompositionStatistics(dc, &st);
+    
+    printf("\tcuts        %u edge cuts, %u vertex cuts\n", 
+           st.edgeCuts, st.vertexCuts);
+    printf("\tpieces      %u searched, largest %u vertices\n", 
+           st.pieces, st.largest);
+}
+
+static void
+print_symmetry(HCSymmetryRef sy)
+{
+    HCSymmetryStatistics st;
+    
+    getSymmetryStatistics(sy, &st);
+    
+    printf("\tsymmetry    start %d, %u automorphism tests\n", 
+           st.start, st.tests);
+    printf("\tprefixes    %u searched for %" c_PF_ULongLong "\n", 
+           st.prefixes, st.covered);
+}
+
+static void
+dump_trace(HCStateRef hc, char *name, char *file)
+{
+    FILE *f;
+    
+    if (!(f = fopen(file, "w"))) {
+        fprintf(stderr, "cannot write trace file %s\n", file);
+        return;
+    }
+    fprintf(f, "# %s\n", name);
+    writeHCTrace(hc, f);
+    fclose(f);
+}
+
+static void
+print_estimate(HCStateRef hc, char *name, ULongLong probes)
+{
+    HCEstimate est;
+    
+    estimateHamiltonianCycles(hc, probes, ESTIMATE_SEED, &est);
     
+    printf("%s has about %.4g (+- %.2g) Hamiltonian Cycles, search tree "
+           "about %.4g (+- %.2g) nodes, %" c_PF_ULongLong " probes.\n", 
+           name, est.cycles, est.cyclesError, est.nodes, est.nodesError,
+           est.probes);
+}
+
+static void
+print_edge_counts(HCStateRef hc, Graph *g, VArray *lb, bool prune)
+{
+    Vertex    *edges, x, y;
+    ULongLong *through, c;
+    UInt       e;
+    
+    UInt       m = g->edge_count;
+    
+    edges   = malloc(2 * m * sizeof(Vertex));
+    through = malloc(m * sizeof(ULongLong));
+    if (!edges || !through) {
+        free(edges);
+        free(through);
+        return;
+    }
+    
+    listEdges(g, edges);
+    c = countHamiltonianCyclesPerEdge(hc, prune, edges, m, through);
+    
+    if (getHCSearchStatus(hc) == HC_SEARCH_UNDECIDED)
+        printf("%s has at least %" c_PF_ULongLong 
+               " Hamiltonian Cycles (time limit reached).\n", g->name, c);
+    else
+        printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
+               g->name, c);
+    
+    for (e = 0; c && e < m; e++) {
+        x = edges[2 * e];
+        y = edges[2 * e + 1];
+        if (lb) {
+            x = lb->array[x - 1];
+            y = lb->array[y - 1];
+        }
+        printf("\t%d-%d %" c_PF_ULongLong "\n", x < y ? x : y, 
+               x < y ? y : x, through[e]);
+    }
+    
+    free(through);
+    free(edges);
+}
+
+static void
+request_report(int sig)
+{
+    report_requested = 1;
+}
+
+static void
+print_duration(double t)
+{
+    ULongLong u = (ULongLong)t;
+    
+    if (u >= 86400) 
+        fprintf(stderr, "%" c_PF_ULongLong "d", u / 86400);
+    fprintf(stderr, "%02u:%02u:%02u", (UInt)(u / 3600 % 24), 
+            (UInt)(u / 60 % 60), (UInt)(u % 60));
+}
+
+static void
+print_progress(HCStateRef hc, char *name, double elapsed)
+{
+    HCProgress p;
+    
+    getHCProgress(hc, &p);
+    
+    fprintf(stderr, "%s: %.4f%% done, %" c_PF_ULongLong " cycles, "
+            "%.0f rotations/s, elapsed ", name, 100.0 * p.fraction, 
+            p.cycles, elapsed > 0 ? p.rotations / elapsed : 0.0);
+    print_duration(elapsed);
+    
+    fputs(", remaining ", stderr);
+    if (p.fraction > 0) 
+        print_duration(elapsed * (1.0 - p.fraction) / p.fraction);
+    else fputs("unknown", stderr);
+    fputs("\n", stderr);
 }
 
 int main(int argc, char ** argv)
 {
-    Graph *g;
+    Graph *g, *h;
     GraphIteratorRef i;
     HCStateRef hc;
-    VArray *vo;
+    HCKernelRef kr = NULL;
+    HCDecompositionRef dc = NULL;
+    HCSymmetryRef sy = NULL;
+    VArray *vo, *lb;
     Status  stat = STATUS_OK;
     StatusRef  s = &stat;
     UInt    pts; 
 	ULongLong c;
     UInt    t;
     bool    prune = 0;
+    bool    relabel = 0;
+    bool    stats   = 0;
+    bool    edges   = 0;
+    double  seconds = 0;
+    double  every   = 0;
+    ULongLong probes = 0;
+    UInt    memo    = 0;
+    double  start, next, now;
+    char   *trace = NULL;
+    ULongLong before;
+    HCSearchStatus found;
+    Vertex  from = 0, to = 0;
+    bool    path = false;
+    bool    tables = true;
+    UInt    inclusion = 0;
+    double  cost;
+    bool    chosen;
+    UHugeInt huge;
+    char   *end;
     
     if (argc == 1) { 
         print_usage();
         exit(0);
     }
-    /* first scan arguments for -h or -p flags */
+    /* first scan arguments for flags */
     for (t = 0; t < argc; t++) {
         if (argv[t][0] == '-' && argv[t][1]){
-            if (argv[t][1]=='h'){ 
+            switch (argv[t][1]) {
+            case 'h':
                 print_usage();
                 exit(0);
+            case 'a':
+                sy = allocateSymmetry(s);
+                break;
+            case 'b':
+                tables = false;
+                break;
+            case 'c':
+                dc = allocateDecomposition(s);
+                break;
+            case 'd':
+                trace = argv[t] + 2;
+                break;
+            case 'e':
+                probes = argv[t][2] ? strtoull(argv[t] + 2, NULL, 10) 
+                                    : ESTIMATE_PROBES;
+                break;
+            case 'i':
+                every = atof(argv[t] + 2);
+                break;
+            case 'I':
+                inclusion = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                       : INCLUSION_THREADS;
+                break;
+            case 'k':
+                kr = allocateKernel(s);
+                break;
+            case 'l':
+                path = true;
+                from = strtoul(argv[t] + 2, &end, 10);
+                if (*end == '-') to = strtoul(end + 1, NULL, 10);
+                break;
+            case 'm':
+                memo = argv[t][2] ? strtoul(argv[t] + 2, NULL, 10) 
+                                  : MEMO_ENTRIES;
+                break;
+            case 'p':
+                prune = true;
+                break;
+            case 'r':
+                relabel = true;
+                break;
+            case 's':
+                stats = true;
+                break;
+            case 't':
+                seconds = atof(argv[t] + 2);
+                break;
+            case 'u':
+                edges = true;
+                break;
             }
-            prune = argv[t][1] == 'p';
         }
-    }    
+    }
 
+    if (memo && prune) {
+        fprintf(stderr, "hc_count: the table count of -m does not prune, "
+                        "it cannot be used with -p\n");
+        exit(1);
+    }
+    
+    signal(SIGUSR1, request_report);
+    
     i = allocateGraphIterator(s);
     initGraphIteratorWithFiles(i,argc - 1 , ++argv);
     
     while ( loadNextGraph(i, &g, s) ){
         
-        pts = g->vertex_count;
+        /* paths are counted on the graph as given */
+        
+        if (path) {
+            print_path_count(g, from, to, prune, seconds, s);
+            releaseGraph(g);
+            continue;
+        }
+        
+        if (kr) {
+            
+            /* search the reduced graph, it has as many cycles as g */
+            
+            if (reduceGraph(kr, g, s) == HC_KERNEL_NO_CYCLE) {
+                printf("%s has 0 Hamiltonian Cycles.\n", g->name);
+                if (stats) printf("\t%s\n", getKernelReason(kr));
+                releaseGraph(g);
+                continue;
+            }
+            h = copyGraph(getKernelGraph(kr), s);
+            releaseGraph(g);
+            g = h;
+            if (stats) print_kernel(kr, g);
+        }
+        
+        if (sy) {
+            initSymmetry(sy, prune, seconds);
+            if (countBySymmetry(sy, g, &c, s) == HC_SEARCH_UNDECIDED)
+                printf("%s: time limit reached.\n", g->name);
+            else
+                printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
+                         g->name, c);
+            if (stats) print_symmetry(sy);
+            releaseGraph(g);
+            continue;
+        }
+        
+        if (dc) {
+            
+            /* the pieces are counted separately, there is no single 
+               search to report on */
+            
+            initDecomposition(dc, prune, seconds);
+            if (countByDecomposition(dc, g, &c, s) == HC_SEARCH_UNDECIDED)
+                printf("%s: time limit reached.\n", g->name);
+            else
+                printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
+                         g->name, c);
+            if (stats) print_decomposition(dc);
+            releaseGraph(g);
+            continue;
+        }
+        
+        if (inclusion) {
+            if (countByInclusion(g, inclusion, seconds, &huge, s) 
+                  == HC_SEARCH_UNDECIDED)
+                printf("%s: time limit reached, or too many cycles for "
+                       "the sum.\n", g->name);
+            else print_huge_count(g->name, huge, false);
+            releaseGraph(g);
+            continue;
+        }
+        
+        /* graphs of small width go to the path decomposition, and other
+           small graphs to the subset table or the inclusion-exclusion 
+           sum, once the tape engine has run as long as they would take */
+        
+        pts    = g->vertex_count;
+        chosen = tables && !relabel && !probes && !edges && !memo && 
+                 !stats && !trace && every <= 0;
+        
+        if (chosen) {
+            cost = pathDecompositionCost(g, s);
+            if (cost <= HC_PATH_AUTO_COST && 
+                (pts > HC_INCLUSION_AUTO_VERTICES || 
+                 cost < (double)((ULongLong)1 << pts) * pts / 2)) {
+                found = countByTapeThenPaths(g, prune, seconds, &huge, s);
+            } else if (pts <= HC_BITS_COUNT_TABLE) {
+                found = countBySubsets(g, &c, prune, seconds, s);
+                huge  = c;
+            } else if (pts <= HC_INCLUSION_AUTO_VERTICES) {
+                found = countByTapeThenInclusion(g, INCLUSION_THREADS, prune,
+                                                 seconds, &huge, s);
+            } else chosen = false;
+        }
+        
+        if (chosen) {
+            print_huge_count(g->name, huge, found == HC_SEARCH_UNDECIDED);
+            releaseGraph(g);
+            continue;
+        }
+        
+        lb  = NULL;
+        
+        if (relabel) {
+            
+            /* renumber vertices so that neighbours are stored close
+               to each other */
+            
+            lb = sortVerticesBandwidth(
+                    initVArray(allocateVArray(pts, s)), g, s);
+            h  = relabelGraph(g, lb, s);
+            releaseGraph(g);
+            g  = h;
+        }
+        
         vo  = sortVerticesDegreeDesc( 
                     initVArray(allocateVArray(pts, s)), g->degree);
         
         hc = initHCState(allocateHCState(g->vertex_count, s),
                          g->degree, g->adj_lists, vo);
         
-		c = 0;
-        if (firstHamiltonianCycle(hc))		
-			do c++; while (nextHamiltonianCycle(hc));
-        printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
-                 g->name, c);
+        if (probes) print_estimate(hc, g->name, probes);
+        else if (edges) {
+            setHCSearchLimits(hc, 0, seconds);
+            print_edge_counts(hc, g, lb, prune);
+        } else if (memo) {
+            setHCSearchLimits(hc, 0, seconds);
+            c = countHamiltonianCycles(hc, memo);
+            
+            if (getHCSearchStatus(hc) == HC_SEARCH_UNDECIDED)
+                printf("%s has at least %" c_PF_ULongLong 
+                       " Hamiltonian Cycles (time limit reached).\n", 
+                         g->name, c);
+            else
+                printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
+                         g->name, c);
+        } else {
+            setHCSearchLimits(hc, 0, seconds);
+            trackHCProgress(hc, true);
+        
+            c     = 0;
+            start = monotonicSeconds();
+            next  = every > 0 ? start + every : 0;
+        
+            /* run the search in slices so that progress can be reported */
+        
+            do {
+                before = getHCRotationCount(hc);
+                found  = stepHamiltonianCycle(hc, PROGRESS_STEP, prune);
+            
+                if (found == HC_SEARCH_CYCLE) c++;
+            
+                /* a slice cut short by the time limit ends the count */
+            
+                if (found == HC_SEARCH_UNDECIDED 
+                      && getHCRotationCount(hc) - before < PROGRESS_STEP) break;
+            
+                if (report_requested || next > 0) {
+                    now = monotonicSeconds();
+                    if (report_requested || now >= next) {
+                        report_requested = 0;
+                        print_progress(hc, g->name, now - start);
+                        if (trace) dump_trace(hc, g->name, trace);
+                        if (next > 0) next = now + every;
+                    }
+                }
+            
+            } while (found != HC_SEARCH_EXHAUSTED);
+        
+            if (getHCSearchStatus(hc) == HC_SEARCH_UNDECIDED) {
+                if (trace) dump_trace(hc, g->name, trace);
+                printf("%s has at least %" c_PF_ULongLong 
+                       " Hamiltonian Cycles (time limit reached).\n", 
+                         g->name, c);
+            } else {
+                printf("%s has %" c_PF_ULongLong " Hamiltonian Cycles.\n", 
+                         g->name, c);
+            }
+        }
+        
+        if (stats) print_statistics(hc);
+        
         releaseHCState(hc);
         releaseVArray(vo);
+        if (lb) releaseVArray(lb);
         releaseGraph(g);
     }
     
     releaseGraphIterator(i);
+    releaseKernel(kr);
+    releaseDecomposition(dc);
+    releaseSymmetry(sy);
     return 0;
 }
 
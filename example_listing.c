@@ -24,6 +24,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "GraphIO.h"
 #include "HamiltonianCycle.h"
 #include "VertexOrder.h"
+#include "GraphReduction.h"
 
 #define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
 "This program is free software: you can redistribute it and/or modify\n"\
@@ -45,8 +46,11 @@ print_usage()
 	puts(COPYRIGHT);
 	puts("This program outputs all hamiltonian cycles found"
 		" for the inputed graphs.\n");
-	puts("Usage: hc [-p] files...\n");
-    puts("Flags:\n\t-h\thelp\n\t-p\tUse pruning algorithm during search.\n");
+	puts("Usage: hc [-k] [-p] [-r] files...\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-k\tSearch the reduced graph and map its cycles back.\n"
+         "\t-p\tUse pruning algorithm during search.\n"
+         "\t-r\tRelabel vertices for memory locality before searching.\n");
     
 }
 
@@ -70,31 +74,77 @@ print_cycle(Vertex *c, UInt pts)
 }
 
 
+/*! Print the cycle on the tape of hc, a cycle of the kernel graph of kr
+when kr is given, of a graph of pts vertices. */
+
+/*! Print the current cycle of hc, in the original graph when it is the
+kernel of kr.  Returns false when out of memory. */
+
+static bool
+print_current(HCStateRef hc, HCKernelRef kr, Vertex *cycle, UInt pts, 
+              Status *s)
+{
+    Vertex *kc;
+    UInt    kpts;
+    
+    memset(cycle, 0, sizeof(Vertex) * (pts * 2 + 1));
+    
+    if (!kr) {
+        getCurrentHamiltonianCycle(hc, cycle);
+        print_cycle(cycle, pts);
+        return true;
+    }
+    
+    kpts = getKernelGraph(kr)->vertex_count;
+    if (!(kc = calloc(2 * kpts + 1, sizeof(Vertex)))) {
+        *s = STATUS_NO_MEM;
+        return false;
+    }
+    
+    getCurrentHamiltonianCycle(hc, kc);
+    expandKernelCycle(kr, kc, cycle, s);
+    if (*s == STATUS_OK) print_cycle(cycle, pts);
+    
+    free(kc);
+    return *s == STATUS_OK;
+}
+
 int main(int argc, char ** argv)
 {
-    Graph *g;
+    Graph *g, *h;
     GraphIteratorRef i;
     HCStateRef hc;
-    VArray *vo;
+    HCKernelRef kr = NULL;
+    VArray *vo, *lb;
     Status  stat = STATUS_OK;
     StatusRef  s = &stat;
-    UInt    pts; 
+    UInt    pts, opts; 
     Vertex *cycle;
     UInt    t;
     bool    prune = 0;
+    bool    relabel = 0;
   
     if (argc == 1) { 
         print_usage();
         exit(0);
     }   
-    /* first scan arguments for -h or -p flags */
+    /* first scan arguments for flags */
     for (t = 0; t < argc; t++) {
         if (argv[t][0] == '-' && argv[t][1]){
-            if (argv[t][1]=='h'){ 
+            switch (argv[t][1]) {
+            case 'h':
                 print_usage();
                 exit(0);
+            case 'k':
+                kr = allocateKernel(s);
+                break;
+            case 'p':
+                prune = true;
+                break;
+            case 'r':
+                relabel = true;
+                break;
             }
-            prune = argv[t][1] == 'p';
         }
     }
 
@@ -103,42 +153,77 @@ int main(int argc, char ** argv)
     
     while ( loadNextGraph(i, &g, s) ){
         
+        opts = g->vertex_count;
+        
+        if (kr) {
+            
+            /* search the reduced graph and expand its cycles */
+            
+            if (reduceGraph(kr, g, s) == HC_KERNEL_NO_CYCLE) {
+                releaseGraph(g);
+                continue;
+            }
+            h = copyGraph(getKernelGraph(kr), s);
+            releaseGraph(g);
+            g = h;
+        }
+        
         pts = g->vertex_count;
+        lb  = NULL;
+        
+        if (relabel) {
+            
+            /* renumber vertices so that neighbours are stored close
+               to each other */
+            
+            lb = sortVerticesBandwidth(
+                    initVArray(allocateVArray(pts, s)), g, s);
+            h  = relabelGraph(g, lb, s);
+            releaseGraph(g);
+            g  = h;
+        }
+        
         vo  = sortVerticesDegreeDesc( 
                     initVArray(allocateVArray(pts, s)), g->degree);
         
         hc = initHCState(allocateHCState(g->vertex_count, s),
                          g->degree, g->adj_lists, vo);
+        setHCStateLabels(hc, lb);
                          
-        cycle = malloc(sizeof(Vertex) * (pts * 2) + 1 );
-        
-        if (prune) {
+        if (!(cycle = malloc(sizeof(Vertex) * (opts * 2 + 1)))) {
+            stat = STATUS_NO_MEM;
+        } else if (prune) {
             if (firstHamiltonianCycleWithPruning(hc)){
                 printf("Hamiltonian Cycles for %s:\n", g->name);
     			do {
-    			    memset(cycle, 0, sizeof(Vertex) * (pts * 2) + 1);
-                    getCurrentHamiltonianCycle(hc,cycle);
-                    print_cycle(cycle,pts);
+    			    if (!print_current(hc, kr, cycle, opts, s)) break;
     			} while (nextHamiltonianCycleWithPruning(hc));
     		}
         } else {
             if (firstHamiltonianCycle(hc)){
                 printf("Hamiltonian Cycles for %s:\n", g->name);		
    			    do {
-    			    memset(cycle, 0, sizeof(Vertex) * (pts * 2) + 1);
-                    getCurrentHamiltonianCycle(hc,cycle);
-                    print_cycle(cycle,pts);
+    			    if (!print_current(hc, kr, cycle, opts, s)) break;
     			} while (nextHamiltonianCycle(hc));             
     		}    
         }
         free(cycle);
         releaseHCState(hc);
         releaseVArray(vo);
+        if (lb) releaseVArray(lb);
+        
+        if (stat != STATUS_OK) {
+            fprintf(stderr, "hc_list_cycles: out of memory listing the "
+                            "cycles of %s.\n", g->name);
+            releaseGraph(g);
+            break;
+        }
         releaseGraph(g);
     }
     
     releaseGraphIterator(i);
-    return 0;
+    releaseKernel(kr);
+    return stat != STATUS_OK;
 }
 
 
@@ -0,0 +1,497 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+/* the engine primitives are static, so the micro benchmarks are compiled
+   together with the engine rather than linked against it */
+
+#include "HamiltonianCycle.c"
+
+#include "GraphGenerators.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
+"This program is free software: you can redistribute it and/or modify\n"\
+"it under the terms of the GNU General Public License as published by\n"\
+"the Free Software Foundation, either version 3 of the License, or\n"\
+"(at your option) any later version.\n"\
+"\n"\
+"This program is distributed in the hope that it will be useful,\n"\
+"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"\
+"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"\
+"GNU General Public License for more details.\n"\
+"\n"\
+"You should have received a copy of the GNU General Public License\n"\
+"along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
+
+/* defaults for the synthetic graph and the number of timed rounds */
+
+#define MICRO_VERTICES 3000
+#define MICRO_DEGREE   3
+#define MICRO_ROUNDS   20
+#define MICRO_SEED     20090101ULL
+
+/* hardware counters read around the timed part of each round */
+
+enum { 
+    CTR_CYCLES, CTR_INSTRUCTIONS, CTR_CACHE_MISSES, CTR_BRANCH_MISSES, 
+    CTR_COUNT 
+};
+
+typedef struct micro_counters {
+    int        fd[CTR_COUNT];    /* -1 when the counter is unavailable */
+    ULongLong  value[CTR_COUNT];
+} MicroCounters;
+
+/*! Synthetic adjacency state the primitives run on. */
+
+typedef struct micro_state {
+    Graph      *g;
+    Arc       **arcs;        /* every arc, in a fixed random order */
+    UInt        arcCount;
+    Arc        *removed;     /* edges taken out for restoreEdges */
+    UInt        edgeCount;
+    HCStateRef  hc;
+    VArray     *vo;
+    HCDFSRef    dfs;
+    Vertex     *e;           /* no virtual edges, for dfSeparatingSet */
+} MicroState;
+
+/*! A primitive, setup is untimed, run is timed and returns ops done. */
+
+typedef struct micro_bench {
+    char       *name;
+    void      (*setup)(MicroState *m);
+    ULongLong (*run)(MicroState *m);
+} MicroBench;
+
+static void
+print_usage()
+{
+	puts(COPYRIGHT);
+	puts("This program times the engine primitives on a random regular "
+        "graph and\nreports ns/op with hardware counters where the system "
+        "provides them.\n");
+	puts("Usage: hc_microbench [-k<degree>] [-n<vertices>] [-r<rounds>]\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-k\tDegree of the synthetic graph (eg. -k4).\n"
+         "\t-n\tVertices of the synthetic graph (eg. -n2000).\n"
+         "\t-r\tTimed rounds of each primitive (eg. -r50).\n");
+}
+
+#ifdef __linux__
+
+static int
+open_counter(UInt type, ULongLong config)
+{
+    struct perf_event_attr pe;
+    
+    memset(&pe, 0, sizeof(pe));
+    pe.type           = type;
+    pe.size           = sizeof(pe);
+    pe.config         = config;
+    pe.disabled       = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv     = 1;
+    
+    return (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+}
+
+static void
+open_counters(MicroCounters *c)
+{
+    c->fd[CTR_CYCLES]        = open_counter(PERF_TYPE_HARDWARE, 
+                                   PERF_COUNT_HW_CPU_CYCLES);
+    c->fd[CTR_INSTRUCTIONS]  = open_counter(PERF_TYPE_HARDWARE, 
+                                   PERF_COUNT_HW_INSTRUCTIONS);
+    c->fd[CTR_CACHE_MISSES]  = open_counter(PERF_TYPE_HARDWARE, 
+                                   PERF_COUNT_HW_CACHE_MISSES);
+    c->fd[CTR_BRANCH_MISSES] = open_counter(PERF_TYPE_HARDWARE, 
+                                   PERF_COUNT_HW_BRANCH_MISSES);
+}
+
+static void
+switch_counters(MicroCounters *c, bool on)
+{
+    UInt i;
+    
+    for (i = 0; i < CTR_COUNT; i++) {
+        if (c->fd[i] < 0) continue;
+        ioctl(c->fd[i], on ? PERF_EVENT_IOC_ENABLE : PERF_EVENT_IOC_DISABLE,
+              0);
+    }
+}
+
+static void
+read_counters(MicroCounters *c)
+{
+    UInt i;
+    
+    for (i = 0; i < CTR_COUNT; i++) {
+        c->value[i] = 0;
+        if (c->fd[i] < 0) continue;
+        if (read(c->fd[i], c->value + i, sizeof(ULongLong)) 
+              != sizeof(ULongLong)) c->value[i] = 0;
+        ioctl(c->fd[i], PERF_EVENT_IOC_RESET, 0);
+    }
+}
+
+static void
+close_counters(MicroCounters *c)
+{
+    UInt i;
+    
+    for (i = 0; i < CTR_COUNT; i++) if (c->fd[i] >= 0) close(c->fd[i]);
+}
+
+#else
+
+/* no perf_event_open, every counter reports n/a */
+
+static void
+open_counters(MicroCounters *c)
+{
+    UInt i;
+    
+    for (i = 0; i < CTR_COUNT; i++) c->fd[i] = -1;
+}
+
+static void switch_counters(MicroCounters *c, bool on) {}
+
+static void
+read_counters(MicroCounters *c)
+{
+    memset(c->value, 0, sizeof(c->value));
+}
+
+static void close_counters(MicroCounters *c) {}
+
+#endif
+
+/*! Source vertex of arc a, the list it is kept in. */
+
+static inline Vertex
+arc_source(Arc *a)
+{
+    return a->cross->target;
+}
+
+/*! Put every arc back on its list. */
+
+static void
+rebuild_lists(MicroState *m)
+{
+    UInt i;
+    
+    memset(m->g->adj_lists, 0, (m->g->vertex_count + 1) * sizeof(Arc *));
+    for (i = 0; i < m->arcCount; i++) 
+        insertArc(m->g->adj_lists + arc_source(m->arcs[i]), m->arcs[i]);
+}
+
+static void
+setup_insert(MicroState *m)
+{
+    memset(m->g->adj_lists, 0, (m->g->vertex_count + 1) * sizeof(Arc *));
+}
+
+static ULongLong
+run_insert(MicroState *m)
+{
+    UInt   i;
+    Arc  **L = m->g->adj_lists;
+    
+    for (i = 0; i < m->arcCount; i++) 
+        insertArc(L + arc_source(m->arcs[i]), m->arcs[i]);
+    
+    return m->arcCount;
+}
+
+static ULongLong
+run_remove(MicroState *m)
+{
+    UInt   i;
+    Arc  **L = m->g->adj_lists;
+    
+    for (i = 0; i < m->arcCount; i++) 
+        removeArc(L + arc_source(m->arcs[i]), m->arcs[i]);
+    
+    return m->arcCount;
+}
+
+/*! Take every edge out of the graph onto m->removed, as the search does 
+before it restores them. */
+
+static void
+setup_restore(MicroState *m)
+{
+    UInt   i;
+    Arc   *a;
+    Arc  **L = m->g->adj_lists;
+    UInt  *d = m->g->degree;
+    
+    rebuild_lists(m);
+    m->removed   = NULL;
+    m->edgeCount = 0;
+    
+    for (i = 0; i < m->arcCount; i++) {
+        a = m->arcs[i];
+        if (a->target < arc_source(a)) continue;
+        
+        removeArc(L + arc_source(a), a);
+        removeArc(L + a->target, a->cross);
+        d[a->target]--;
+        d[arc_source(a)]--;
+        
+        a->next    = m->removed;
+        m->removed = a;
+        m->edgeCount++;
+    }
+}
+
+static ULongLong
+run_restore(MicroState *m)
+{
+    restoreEdges(NULL, m->g->adj_lists, m->removed, m->g->degree);
+    return m->edgeCount;
+}
+
+static void
+setup_prime(MicroState *m)
+{
+    resetStateAndRestoreGraph(m->hc);
+}
+
+/*! One whole descent of primeTape from an empty tape, anchors placed by
+extendAnchor and segments grown by extendSegments until the first dead
+end or cycle, one op per tape position written.  The forced vertex 
+checks and anchor choices are in the time as well as the extensions. */
+
+static ULongLong
+run_prime(MicroState *m)
+{
+    primeTape(m->hc);
+    return m->hc->pos - m->hc->origin;
+}
+
+static void
+setup_unwind(MicroState *m)
+{
+    resetStateAndRestoreGraph(m->hc);
+    primeTape(m->hc);
+}
+
+/*! Unwind the tape of one descent, one op per tape position. */
+
+static ULongLong
+run_unwind(MicroState *m)
+{
+    ULongLong ops = m->hc->pos - m->hc->origin;
+    
+    restoreGraph(m->hc);
+    
+    /* the graph is whole again, leave nothing for the next reset */
+    
+    m->hc->pos          = m->hc->origin;
+    m->hc->removedEdges = NULL;
+    return ops;
+}
+
+static void
+setup_separating(MicroState *m)
+{
+    initDfSeparatingSet(m->dfs);
+}
+
+/*! Depth first search for cut points and bipartition, one op per vertex
+visited. */
+
+static ULongLong
+run_separating(MicroState *m)
+{
+    UInt diff = 0;
+    bool cp   = false;
+    
+    return dfSeparatingSet(m->dfs, m->g->adj_lists, m->e, 1, 0, &diff, 
+                           false, &cp);
+}
+
+static MicroBench benches[] = {
+    { "insertArc",       setup_insert,     run_insert     },
+    { "removeArc",       rebuild_lists,    run_remove     },
+    { "restoreEdges",    setup_restore,    run_restore    },
+    { "primeTape",       setup_prime,      run_prime      },
+    { "unwind",          setup_unwind,     run_unwind     },
+    { "dfSeparatingSet", setup_separating, run_separating },
+    { NULL,              NULL,             NULL           }
+};
+
+static void
+print_ratio(MicroCounters *c, UInt num, UInt den, double per)
+{
+    if (c->fd[num] < 0 || (den < CTR_COUNT && c->fd[den] < 0)) {
+        printf(" %12s", "n/a");
+        return;
+    }
+    
+    printf(" %12.3f", (double)c->value[num] / 
+        (den < CTR_COUNT ? (c->value[den] ? (double)c->value[den] : 1.0) 
+                         : per));
+}
+
+/*! Run b for rounds timed rounds, report the fastest round's ns/op and 
+the counters summed over all rounds. */
+
+static void
+run_bench(MicroState *m, MicroBench *b, UInt rounds, MicroCounters *c)
+{
+    UInt       r;
+    ULongLong  ops, total = 0;
+    double     t, best = 0;
+    ULongLong  sum[CTR_COUNT];
+    
+    memset(sum, 0, sizeof(sum));
+    
+    for (r = 0; r < rounds; r++) {
+        b->setup(m);
+        
+        read_counters(c);
+        switch_counters(c, true);
+        t   = monotonicSeconds();
+        ops = b->run(m);
+        t   = monotonicSeconds() - t;
+        switch_counters(c, false);
+        read_counters(c);
+        
+        if (!ops) ops = 1;
+        t /= ops;
+        if (!r || t < best) best = t;
+        
+        total += ops;
+        sum[CTR_CYCLES]        += c->value[CTR_CYCLES];
+        sum[CTR_INSTRUCTIONS]  += c->value[CTR_INSTRUCTIONS];
+        sum[CTR_CACHE_MISSES]  += c->value[CTR_CACHE_MISSES];
+        sum[CTR_BRANCH_MISSES] += c->value[CTR_BRANCH_MISSES];
+    }
+    
+    memcpy(c->value, sum, sizeof(sum));
+    
+    printf("%-16s %10" c_PF_ULongLong " %10.2f", b->name, 
+           total / rounds, best * 1e9);
+    print_ratio(c, CTR_INSTRUCTIONS, CTR_CYCLES, 0);
+    print_ratio(c, CTR_CACHE_MISSES, CTR_COUNT, (double)total);
+    print_ratio(c, CTR_BRANCH_MISSES, CTR_COUNT, (double)total);
+    printf("\n");
+}
+
+int main(int argc, char ** argv)
+{
+    MicroState     m;
+    MicroCounters  c;
+    MicroBench    *b;
+    RandomState    r;
+    Arc           *a;
+    Vertex         x;
+    Status         stat = STATUS_OK;
+    StatusRef      s = &stat;
+    UInt           t, i;
+    UInt           pts    = MICRO_VERTICES;
+    UInt           k      = MICRO_DEGREE;
+    UInt           rounds = MICRO_ROUNDS;
+    
+    for (t = 1; t < argc; t++) {
+        if (argv[t][0] == '-' && argv[t][1]){
+            switch (argv[t][1]) {
+            case 'h':
+                print_usage();
+                exit(0);
+            case 'k':
+                k = atoi(argv[t] + 2);
+                break;
+            case 'n':
+                pts = atoi(argv[t] + 2);
+                break;
+            case 'r':
+                rounds = atoi(argv[t] + 2);
+                break;
+            }
+        }
+    }
+    
+    if (!rounds) rounds = 1;
+    
+    seedRandom(&r, MICRO_SEED);
+    
+    memset(&m, 0, sizeof(m));
+    m.g = randomRegularGraph(pts, k, &r, s);
+    if (!m.g) {
+        fprintf(stderr, "hc_microbench: can not build a %u-regular graph "
+                "on %u vertices.\n", k, pts);
+        return 1;
+    }
+    
+    /* all arcs in a random order so that list operations do not simply
+       walk memory in allocation order */
+    
+    m.arcCount = 2 * m.g->edge_count;
+    m.arcs     = malloc(m.arcCount * sizeof(Arc *));
+    m.e        = calloc(pts + 1, sizeof(Vertex));
+    if (!m.arcs || !m.e) return 1;
+    
+    for (i = 0, x = 1; x <= (Vertex)pts; x++) 
+        for (a = m.g->adj_lists[x]; a; a = a->next) m.arcs[i++] = a;
+    
+    for (i = m.arcCount; i > 1; i--) {
+        t           = randomBelow(&r, i);
+        a           = m.arcs[i - 1];
+        m.arcs[i-1] = m.arcs[t];
+        m.arcs[t]   = a;
+    }
+    
+    m.vo  = sortVerticesDegreeDesc(initVArray(allocateVArray(pts, s)), 
+                                   m.g->degree);
+    m.hc  = initHCState(allocateHCState(pts, s), m.g->degree, 
+                        m.g->adj_lists, m.vo);
+    m.dfs = allocateDFS(pts);
+    if (stat != STATUS_OK || !m.dfs) return 1;
+    
+    open_counters(&c);
+    
+    printf("%s, %u timed rounds\n\n", m.g->name, rounds);
+    printf("%-16s %10s %10s %12s %12s %12s\n", "primitive", "ops/round",
+           "ns/op", "IPC", "cache-miss/op", "branch-miss/op");
+    
+    for (b = benches; b->name; b++) run_bench(&m, b, rounds, &c);
+    
+    close_counters(&c);
+    
+    releaseDFS(m.dfs);
+    releaseHCState(m.hc);
+    releaseVArray(m.vo);
+    releaseGraph(m.g);
+    free(m.e);
+    free(m.arcs);
+    return 0;
+}
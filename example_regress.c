@@ -0,0 +1,842 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "Graph.h"
+#include "GraphIO.h"
+#include "ArchIO.h"
+#include "GraphGenerators.h"
+#include "GraphReduction.h"
+#include "GraphDecomposition.h"
+#include "GraphSymmetry.h"
+#include "HamiltonianCycle.h"
+#include "HamiltonianPath.h"
+#include "PortfolioSearch.h"
+#include "BitSearch.h"
+#include "InclusionExclusion.h"
+#include "PathDecomposition.h"
+#include "VertexOrder.h"
+#include "VertexDeletion.h"
+#include "Timer.h"
+
+#define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
+"This program is free software: you can redistribute it and/or modify\n"\
+"it under the terms of the GNU General Public License as published by\n"\
+"the Free Software Foundation, either version 3 of the License, or\n"\
+"(at your option) any later version.\n"\
+"\n"\
+"This program is distributed in the hope that it will be useful,\n"\
+"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"\
+"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"\
+"GNU General Public License for more details.\n"\
+"\n"\
+"You should have received a copy of the GNU General Public License\n"\
+"along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
+
+#define REGRESS_GRAPHS    "TestGraphs.txt"
+#define REGRESS_GOLDEN    "GoldenCounts.txt"
+#define REGRESS_BASELINE  "RegressBaseline.txt"
+
+/* defaults for the number of timed passes over the corpus, the allowed 
+   slowdown in percent and the time limit of a single run.  Totals below
+   REGRESS_NOISE seconds are too short to compare. */
+
+#define REGRESS_REPEATS   3
+#define REGRESS_PERCENT   25.0
+#define REGRESS_SECONDS   60.0
+#define REGRESS_NOISE     0.01
+#define REGRESS_SEED      20090101ULL
+
+#define REGRESS_STEP      4096
+#define REGRESS_MEMO      (1 << 16)
+#define RESTART_UNIT      100
+#define RESTART_COUNT     64
+#define REGRESS_INCLUSION_THREADS 2
+#define REGRESS_DELETION_THREADS  2
+
+/* the vertex pairs are searched on graphs of at most this many vertices,
+   on larger ones they take longer than the rest of the corpus */
+
+#define REGRESS_PAIRS_VERTICES    40
+
+/* probes of the estimate, which must be within a factor of 
+   REGRESS_ESTIMATE_FACTOR of the stored count and zero exactly when the 
+   count is */
+
+#define REGRESS_PROBES    10000
+#define REGRESS_ESTIMATE_FACTOR 2
+
+#define LINE_LENGTH       1024
+
+/*! A generated graph of the corpus, a and b are family parameters. */
+
+typedef struct regress_case {
+    char   *family;
+    UInt    a, b;
+    double  radius;
+} RegressCase;
+
+static RegressCase corpus[] = {
+    { "gp",        20, 3, 0   },
+    { "gp",        30, 7, 0   },
+    { "hypo",       5, 0, 0   },   /* GP(35,2) */
+    { "hypo",       6, 0, 0   },   /* GP(41,2) */
+    { "regular",   60, 3, 0   },
+    { "regular",   24, 4, 0   },
+    { "grid",       6, 6, 0   },
+    { "moebius",   20, 0, 0   },
+    { "moebius",   32, 0, 0   },   /* 64 vertices, a full word */
+    { "geometric", 16, 0, 0.45},
+    { "geometric", 20, 0, 0.39},
+    { NULL,         0, 0, 0   }
+};
+
+typedef enum {
+    ENGINE_COUNT,       /* first/next until exhausted              */
+    ENGINE_STEP,        /* time sliced count with the step api     */
+    ENGINE_RELABEL,     /* count on the bandwidth relabeled graph  */
+    ENGINE_KERNEL,      /* count on the reduced graph              */
+    ENGINE_MEMO,        /* count memoizing residual graphs         */
+    ENGINE_SPLIT,       /* count the pieces of small cuts          */
+    ENGINE_SYMMETRY,    /* count one prefix per automorphism orbit */
+    ENGINE_BITS,        /* count with adjacency words              */
+    ENGINE_SUBSETS,     /* count on the tape, then a subset table  */
+    ENGINE_INCLUSION,   /* count by a sum over vertex subsets      */
+    ENGINE_PATHS,       /* count over a path decomposition         */
+    ENGINE_ESTIMATE,    /* random probe estimate of the count      */
+    ENGINE_EDGE_COUNTS, /* cycles through each edge                */
+    ENGINE_CONSTRAINED, /* count with a required and forbidden edge */
+    ENGINE_HAMILTON_PATHS, /* Hamilton paths from the first vertex */
+    ENGINE_VERTEX_DELETED, /* Hamiltonian subgraphs g - v          */
+    ENGINE_EDGE_DELETED, /* edges on every Hamilton cycle          */
+    ENGINE_PATH_PAIRS,  /* vertex pairs joined by a Hamilton path  */
+    ENGINE_DECIDE,      /* first only                              */
+    ENGINE_NOGOODS,     /* decision skipping known dead ends       */
+    ENGINE_PIECES,      /* decide the pieces of small cuts         */
+    ENGINE_ORBITS,      /* decide one prefix per orbit             */
+    ENGINE_BIT_DECIDE,  /* decide with adjacency words             */
+    ENGINE_SUBSET_DECIDE, /* decide on the tape, then a subset table */
+    ENGINE_PATH_DECIDE, /* decide over a path decomposition        */
+    ENGINE_RESTARTS,    /* decision with randomized restarts       */
+    ENGINE_PORTFOLIO    /* decision racing the default portfolio   */
+} EngineKind;
+
+/*! The stored answers of a graph, one column of the golden file each.
+The edge counts are stored as the sum of (e+1) times the cycles through
+edge e, over the edges e in the order of listEdges. */
+
+typedef enum {
+    ANSWER_CYCLES,          /* Hamilton cycles                     */
+    ANSWER_THROUGH,         /* weighted cycles through each edge   */
+    ANSWER_CONSTRAINED,     /* cycles on the first, off the last edge */
+    ANSWER_PATHS,           /* Hamilton paths from vertex 1        */
+    ANSWER_VERTEX_DELETED,  /* Hamiltonian subgraphs g - v         */
+    ANSWER_EDGE_DELETED,    /* edges on every Hamilton cycle       */
+    ANSWER_PATH_PAIRS,      /* pairs joined by a Hamilton path     */
+    ANSWER_COUNT
+} RegressAnswer;
+
+/*! A way of running the search and the stored answer it is checked 
+against, decisions are checked against the stored count being non zero.
+The first engine of each answer writes it with -g. */
+
+typedef struct regress_engine {
+    char         *name;
+    EngineKind    kind;
+    bool          prune;
+    RegressAnswer answer;
+} RegressEngine;
+
+static RegressEngine engines[] = {
+    { "count",            ENGINE_COUNT,     false, ANSWER_CYCLES },
+    { "count-prune",      ENGINE_COUNT,     true,  ANSWER_CYCLES },
+    { "step",             ENGINE_STEP,      false, ANSWER_CYCLES },
+    { "step-prune",       ENGINE_STEP,      true,  ANSWER_CYCLES },
+    { "count-relabel",    ENGINE_RELABEL,   false, ANSWER_CYCLES },
+    { "count-kernel",     ENGINE_KERNEL,    false, ANSWER_CYCLES },
+    { "count-memo",       ENGINE_MEMO,      false, ANSWER_CYCLES },
+    { "count-split",      ENGINE_SPLIT,     false, ANSWER_CYCLES },
+    { "count-symmetry",   ENGINE_SYMMETRY,  false, ANSWER_CYCLES },
+    { "count-bits",       ENGINE_BITS,      false, ANSWER_CYCLES },
+    { "count-subsets",    ENGINE_SUBSETS,   false, ANSWER_CYCLES },
+    { "count-inclusion",  ENGINE_INCLUSION, false, ANSWER_CYCLES },
+    { "count-paths",      ENGINE_PATHS,     false, ANSWER_CYCLES },
+    { "estimate",         ENGINE_ESTIMATE,  false, ANSWER_CYCLES },
+    { "count-per-edge",   ENGINE_EDGE_COUNTS, false, ANSWER_THROUGH },
+    { "count-constrained", ENGINE_CONSTRAINED, false, ANSWER_CONSTRAINED },
+    { "count-ham-paths",  ENGINE_HAMILTON_PATHS, false, ANSWER_PATHS },
+    { "vertex-deleted",   ENGINE_VERTEX_DELETED, false, 
+                          ANSWER_VERTEX_DELETED },
+    { "edge-deleted",     ENGINE_EDGE_DELETED, false, ANSWER_EDGE_DELETED },
+    { "path-pairs",       ENGINE_PATH_PAIRS, false, ANSWER_PATH_PAIRS },
+    { "decide",           ENGINE_DECIDE,    false, ANSWER_CYCLES },
+    { "decide-prune",     ENGINE_DECIDE,    true,  ANSWER_CYCLES },
+    { "decide-nogoods",   ENGINE_NOGOODS,   false, ANSWER_CYCLES },
+    { "decide-split",     ENGINE_PIECES,    false, ANSWER_CYCLES },
+    { "decide-symmetry",  ENGINE_ORBITS,    false, ANSWER_CYCLES },
+    { "decide-bits",      ENGINE_BIT_DECIDE, false, ANSWER_CYCLES },
+    { "decide-subsets",   ENGINE_SUBSET_DECIDE, false, ANSWER_CYCLES },
+    { "decide-paths",     ENGINE_PATH_DECIDE, false, ANSWER_CYCLES },
+    { "decide-restarts",  ENGINE_RESTARTS,  false, ANSWER_CYCLES },
+    { "decide-portfolio", ENGINE_PORTFOLIO, false, ANSWER_CYCLES },
+    { NULL,               ENGINE_COUNT,     false, ANSWER_CYCLES }
+};
+
+/*! A corpus graph and its stored answers. */
+
+typedef struct regress_graph {
+    Graph     *graph;
+    ULongLong  answers[ANSWER_COUNT];
+    bool       known;
+} RegressGraph;
+
+static void
+print_usage()
+{
+	puts(COPYRIGHT);
+	puts("This program runs every search engine on the graphs of " 
+         REGRESS_GRAPHS " (or of\nthe given files) and a generated "
+         "corpus, and fails when a count or decision\ndiffers from "
+         REGRESS_GOLDEN " or an engine is slower than "
+         REGRESS_BASELINE ".\n");
+	puts("Usage: hc_regress [-g] [-b] [-n<runs>] [-x<percent>] "
+         "[files...]\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-g\tWrite the stored counts and query answers and exit.\n"
+         "\t-b\tWrite the timing baseline of this machine.\n"
+         "\t-n\tTimed passes over the corpus, the fastest counts "
+         "(eg. -n5).\n"
+         "\t-x\tAllowed slowdown against the baseline in percent "
+         "(eg. -x10).\n");
+}
+
+/*! True when g is within the size limits of engine en, graphs beyond 
+them are skipped instead of searched on the tape. */
+
+static bool
+engine_applies(RegressEngine *en, Graph *g, Status *s)
+{
+    switch (en->kind) {
+    case ENGINE_BITS:
+    case ENGINE_BIT_DECIDE:
+        return g->vertex_count <= HC_BITS_MAX_VERTICES;
+    case ENGINE_SUBSETS:
+    case ENGINE_INCLUSION:
+        return g->vertex_count <= HC_BITS_COUNT_TABLE;
+    case ENGINE_SUBSET_DECIDE:
+        return g->vertex_count <= HC_BITS_DECIDE_TABLE;
+    case ENGINE_PATHS:
+    case ENGINE_PATH_DECIDE:
+        return pathDecompositionCost(g, s) <= HC_PATH_AUTO_COST;
+    case ENGINE_PATH_PAIRS:
+        return g->vertex_count <= REGRESS_PAIRS_VERTICES;
+    default:
+        return true;
+    }
+} /* engine_applies */
+
+/*! Run the batch query of engine en on g, the number of Hamiltonian 
+subgraphs g - v, of edges on every Hamilton cycle or of vertex pairs joined
+by a Hamilton path in *c.  Undecided when any query is. */
+
+static HCSearchStatus
+run_deletion(RegressEngine *en, Graph *g, UHugeInt *c, Status *s)
+{
+    HCDeletionStatistics st;
+    HCSearchStatus *result;
+    Vertex         *edges = NULL;
+    UInt            n = g->vertex_count;
+    UInt            m = g->edge_count;
+    UInt            k, first = 0, size = n * n;
+    
+    if (en->kind == ENGINE_VERTEX_DELETED) {
+        first = 1;
+        size  = n + 1;
+    } else if (en->kind == ENGINE_EDGE_DELETED) size = m;
+    
+    EM(result, size * sizeof(HCSearchStatus), e0);
+    
+    switch (en->kind) {
+    case ENGINE_VERTEX_DELETED:
+        *c = decideVertexDeletedSubgraphs(g, REGRESS_DELETION_THREADS, 
+                    en->prune, REGRESS_SECONDS, result, &st, s);
+        break;
+    case ENGINE_EDGE_DELETED:
+        EM(edges, 2 * m * sizeof(Vertex), e1);
+        *c = decideEdgeDeletedSubgraphs(g, REGRESS_DELETION_THREADS, 
+                    en->prune, REGRESS_SECONDS, edges, result, &st, s);
+        free(edges);
+        break;
+    default:
+        *c = decideHamiltonianPaths(g, REGRESS_DELETION_THREADS, 
+                    en->prune, REGRESS_SECONDS, result, &st, s);
+        break;
+    }
+    
+    for (k = first; k < size && result[k] != HC_SEARCH_UNDECIDED; k++);
+    free(result);
+    
+    if (*s != STATUS_OK || k < size) return HC_SEARCH_UNDECIDED;
+    return *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+e1: free(result);
+e0: *s = STATUS_NO_MEM;
+    return HC_SEARCH_UNDECIDED;
+} /* run_deletion */
+
+/*! Count the Hamilton paths of g from vertex 1 to any other vertex. */
+
+static HCSearchStatus
+run_paths(RegressEngine *en, Graph *g, UHugeInt *c, Status *s)
+{
+    HCPathRef       p;
+    HCSearchStatus  result;
+    
+    if (!(p = allocateHCPath(g->vertex_count, s))) 
+        return HC_SEARCH_UNDECIDED;
+    
+    initHCPath(p, g->degree, g->adj_lists, 1, 0);
+    setHCSearchLimits(getHCPathState(p), 0, REGRESS_SECONDS);
+    
+    if (firstHamiltonianPath(p, en->prune)) {
+        do (*c)++; while (nextHamiltonianPath(p, en->prune));
+    }
+    
+    result = getHCSearchStatus(getHCPathState(p));
+    releaseHCPath(p);
+    
+    if (result == HC_SEARCH_UNDECIDED) return result;
+    return *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+} /* run_paths */
+
+/*! Run engine en once on a copy of g, return the status of the search 
+and the cycles found in *c.  The counts are kept at the full width of the
+engines that count in a UHugeInt. */
+
+static HCSearchStatus
+run_engine(RegressEngine *en, Graph *g, UHugeInt *c, Status *s)
+{
+    HCStateRef      hc;
+    HCPortfolioRef  pf;
+    HCKernelRef     kr;
+    HCDecompositionRef dc;
+    HCSymmetryRef   sy;
+    HCSearchStatus  result;
+    Graph          *h, *r;
+    VArray         *vo, *lb;
+    HCEstimate      est;
+    ULongLong       before, n;
+    ULongLong      *through = NULL;
+    Vertex         *edges = NULL;
+    UInt            m, k;
+    bool            found;
+    
+    *c = 0;
+    
+    if (en->kind == ENGINE_PORTFOLIO) {
+        pf = initPortfolio(
+                allocatePortfolio(HC_PORTFOLIO_DEFAULT_SIZE, s), NULL);
+        if (!pf) return HC_SEARCH_UNDECIDED;
+        result = runPortfolio(pf, g, s);
+        if (result == HC_SEARCH_CYCLE) *c = 1;
+        releasePortfolio(pf);
+        return result;
+    }
+    
+    if (en->kind == ENGINE_SPLIT || en->kind == ENGINE_PIECES) {
+        dc = initDecomposition(allocateDecomposition(s), en->prune, 
+                               REGRESS_SECONDS);
+        if (!dc) return HC_SEARCH_UNDECIDED;
+        if (en->kind == ENGINE_SPLIT) {
+            result = countByDecomposition(dc, g, &n, s);
+            *c = n;
+        } else {
+            result = decideByDecomposition(dc, g, s);
+            if (result == HC_SEARCH_CYCLE) *c = 1;
+        }
+        releaseDecomposition(dc);
+        return result;
+    }
+    
+    if (en->kind == ENGINE_SYMMETRY || en->kind == ENGINE_ORBITS) {
+        sy = initSymmetry(allocateSymmetry(s), en->prune, REGRESS_SECONDS);
+        if (!sy) return HC_SEARCH_UNDECIDED;
+        if (en->kind == ENGINE_SYMMETRY) {
+            result = countBySymmetry(sy, g, &n, s);
+            *c = n;
+        } else {
+            result = decideBySymmetry(sy, g, s);
+            if (result == HC_SEARCH_CYCLE) *c = 1;
+        }
+        releaseSymmetry(sy);
+        return result;
+    }
+    
+    switch (en->kind) {
+    case ENGINE_VERTEX_DELETED:
+    case ENGINE_EDGE_DELETED:
+    case ENGINE_PATH_PAIRS:
+        return run_deletion(en, g, c, s);
+    case ENGINE_HAMILTON_PATHS:
+        return run_paths(en, g, c, s);
+    default:
+        break;
+    }
+    
+    /* the callers skip graphs beyond the limits of engine_applies */
+    
+    switch (en->kind) {
+    case ENGINE_BITS:
+        result = countByBits(g, &n, REGRESS_SECONDS, s);
+        *c = n;
+        return result;
+    case ENGINE_BIT_DECIDE:
+        result = decideByBits(g, REGRESS_SECONDS, s);
+        if (result == HC_SEARCH_CYCLE) *c = 1;
+        return result;
+    case ENGINE_SUBSETS:
+        result = countBySubsets(g, &n, en->prune, REGRESS_SECONDS, s);
+        *c = n;
+        return result;
+    case ENGINE_INCLUSION:
+        return countByInclusion(g, REGRESS_INCLUSION_THREADS, 
+                                REGRESS_SECONDS, c, s);
+    case ENGINE_PATHS:
+        return countByPathDecomposition(g, REGRESS_SECONDS, c, s);
+    case ENGINE_PATH_DECIDE:
+        result = decideByPathDecomposition(g, REGRESS_SECONDS, s);
+        if (result == HC_SEARCH_CYCLE) *c = 1;
+        return result;
+    case ENGINE_SUBSET_DECIDE:
+        result = decideBySubsets(g, en->prune, REGRESS_SECONDS, s);
+        if (result == HC_SEARCH_CYCLE) *c = 1;
+        return result;
+    default:
+        break;
+    }
+    
+    if (!(h = copyGraph(g, s))) return HC_SEARCH_UNDECIDED;
+    
+    if (en->kind == ENGINE_RELABEL) {
+        lb = sortVerticesBandwidth(
+                initVArray(allocateVArray(h->vertex_count, s)), h, s);
+        r  = lb ? relabelGraph(h, lb, s) : NULL;
+        if (lb) releaseVArray(lb);
+        releaseGraph(h);
+        if (!(h = r)) return HC_SEARCH_UNDECIDED;
+    }
+    
+    if (en->kind == ENGINE_KERNEL) {
+        if (!(kr = allocateKernel(s))) {
+            releaseGraph(h);
+            return HC_SEARCH_UNDECIDED;
+        }
+        if (reduceGraph(kr, h, s) == HC_KERNEL_NO_CYCLE) {
+            releaseKernel(kr);
+            releaseGraph(h);
+            return *s == STATUS_OK ? HC_SEARCH_EXHAUSTED 
+                                   : HC_SEARCH_UNDECIDED;
+        }
+        r = copyGraph(getKernelGraph(kr), s);
+        releaseKernel(kr);
+        releaseGraph(h);
+        if (!(h = r)) return HC_SEARCH_UNDECIDED;
+    }
+    
+    vo = sortVerticesDegreeDesc(
+            initVArray(allocateVArray(h->vertex_count, s)), h->degree);
+    hc = allocateHCState(h->vertex_count, s);
+    if (*s != STATUS_OK) {
+        if (vo) releaseVArray(vo);
+        releaseGraph(h);
+        return HC_SEARCH_UNDECIDED;
+    }
+    
+    initHCState(hc, h->degree, h->adj_lists, vo);
+    setHCSearchLimits(hc, 0, REGRESS_SECONDS);
+    
+    /* the constraints are the first and the last edge listed */
+    
+    m = h->edge_count;
+    if (en->kind == ENGINE_EDGE_COUNTS || en->kind == ENGINE_CONSTRAINED) {
+        edges   = malloc(2 * m * sizeof(Vertex));
+        through = malloc(m * sizeof(ULongLong));
+        if (!edges || !through) {
+            *s = STATUS_NO_MEM;
+            free(edges);
+            free(through);
+            releaseHCState(hc);
+            releaseVArray(vo);
+            releaseGraph(h);
+            return HC_SEARCH_UNDECIDED;
+        }
+        listEdges(h, edges);
+        if (en->kind == ENGINE_CONSTRAINED) 
+            setHCEdgeConstraints(hc, edges, 1, edges + 2 * (m - 1), 
+                                 m > 1 ? 1 : 0);
+    }
+    
+    switch (en->kind) {
+    case ENGINE_STEP:
+        do {
+            before = getHCRotationCount(hc);
+            result = stepHamiltonianCycle(hc, REGRESS_STEP, en->prune);
+            
+            if (result == HC_SEARCH_CYCLE) (*c)++;
+            
+            /* a slice cut short by the time limit ends the count */
+            
+            if (result == HC_SEARCH_UNDECIDED 
+                  && getHCRotationCount(hc) - before < REGRESS_STEP) break;
+        } while (result != HC_SEARCH_EXHAUSTED);
+        break;
+    case ENGINE_MEMO:
+        *c = countHamiltonianCycles(hc, REGRESS_MEMO);
+        break;
+    case ENGINE_ESTIMATE:
+        estimateHamiltonianCycles(hc, REGRESS_PROBES, REGRESS_SEED, &est);
+        *c = (UHugeInt)(est.cycles + 0.5);
+        break;
+    case ENGINE_EDGE_COUNTS:
+        if (countHamiltonianCyclesPerEdge(hc, en->prune, edges, m, through))
+            for (k = 0; k < m; k++) *c += (UHugeInt)(k + 1) * through[k];
+        break;
+    case ENGINE_NOGOODS:
+        if (firstHamiltonianCycleWithNogoods(hc, REGRESS_MEMO)) *c = 1;
+        break;
+    case ENGINE_RESTARTS:
+        if (firstHamiltonianCycleWithRestarts(hc, REGRESS_SEED, 
+                        RESTART_UNIT, RESTART_COUNT, en->prune)) *c = 1;
+        break;
+    default:
+        found = en->prune ? firstHamiltonianCycleWithPruning(hc)
+                          : firstHamiltonianCycle(hc);
+        if (found) (*c)++;
+        
+        if (en->kind < ENGINE_DECIDE && found) {
+            while (en->prune ? nextHamiltonianCycleWithPruning(hc)
+                             : nextHamiltonianCycle(hc)) (*c)++;
+        }
+        break;
+    }
+    
+    result = getHCSearchStatus(hc);
+    if (en->kind == ENGINE_ESTIMATE) result = HC_SEARCH_EXHAUSTED;
+    if (result != HC_SEARCH_UNDECIDED) 
+        result = *c ? HC_SEARCH_CYCLE : HC_SEARCH_EXHAUSTED;
+    
+    releaseHCState(hc);
+    releaseVArray(vo);
+    releaseGraph(h);
+    free(through);
+    free(edges);
+    
+    return result;
+} /* run_engine */
+
+/*! True when the answer c of engine en agrees with the stored answer 
+expected, see REGRESS_ESTIMATE_FACTOR for the estimate. */
+
+static bool
+answer_matches(RegressEngine *en, UHugeInt c, ULongLong expected)
+{
+    if (en->kind >= ENGINE_DECIDE) return (c != 0) == (expected != 0);
+    if (en->kind != ENGINE_ESTIMATE) return c == (UHugeInt)expected;
+    
+    return (double)c * REGRESS_ESTIMATE_FACTOR >= (double)expected &&
+           (double)c <= (double)expected * REGRESS_ESTIMATE_FACTOR;
+} /* answer_matches */
+
+/*! Append g to the corpus array *rg of *n graphs. */
+
+static void
+add_graph(RegressGraph **rg, UInt *n, Graph *g, Status *s)
+{
+    RegressGraph *a;
+    
+    if (!(a = realloc(*rg, (*n + 1) * sizeof(RegressGraph)))) {
+        *s = STATUS_NO_MEM;
+        releaseGraph(g);
+        return;
+    }
+    
+    a[*n].graph  = g;
+    memset(a[*n].answers, 0, sizeof(a[*n].answers));
+    a[*n].known  = false;
+    
+    *rg = a;
+    (*n)++;
+}
+
+/*! Read the stored answers, one "graph<tab>cycles<tab>..." line per 
+graph with the columns of RegressAnswer, into the matching corpus entries.
+A line missing a column leaves its graph unknown.  Returns false if the 
+file cannot be read. */
+
+static bool
+read_golden(char *file, RegressGraph *rg, UInt n)
+{
+    FILE   *f;
+    char    line[LINE_LENGTH];
+    char   *tab, *end;
+    UInt    i, a;
+    
+    if (!(f = fopen(file, "r"))) return false;
+    
+    while (fgets(line, LINE_LENGTH, f)) {
+        if (line[0] == '#' || !(tab = strchr(line, '\t'))) continue;
+        *tab = '\0';
+        
+        for (i = 0; i < n; i++) {
+            if (rg[i].known || strcmp(rg[i].graph->name, line)) continue;
+            
+            for (a = 0; a < ANSWER_COUNT; a++, tab = end) {
+                rg[i].answers[a] = strtoull(tab + 1, &end, 10);
+                if (end == tab + 1) break;
+            }
+            rg[i].known = a == ANSWER_COUNT;
+            break;
+        }
+    }
+    
+    fclose(f);
+    return true;
+}
+
+/*! Look up the stored seconds of engine name in the baseline file, 
+returns a negative value if there is none. */
+
+static double
+read_baseline(char *file, char *name)
+{
+    FILE   *f;
+    char    line[LINE_LENGTH];
+    char   *tab;
+    double  t = -1;
+    
+    if (!(f = fopen(file, "r"))) return t;
+    
+    while (fgets(line, LINE_LENGTH, f)) {
+        if (line[0] == '#' || !(tab = strchr(line, '\t'))) continue;
+        *tab++ = '\0';
+        if (!strcmp(line, name)) t = atof(tab);
+    }
+    
+    fclose(f);
+    return t;
+}
+
+int main(int argc, char ** argv)
+{
+    GraphIteratorRef i;
+    RegressGraph   *rg = NULL;
+    RegressCase    *rc;
+    RegressEngine  *en;
+    Graph          *g;
+    FILE           *f;
+    HCSearchStatus  result;
+    UHugeInt        c;
+    char            buf[MAX_UHugeInt_STR_LEN + 1];
+    Status  stat = STATUS_OK;
+    StatusRef  s = &stat;
+    UInt    t, k, a, run;
+    UInt    n        = 0;
+    UInt    files    = 0;
+    UInt    failures = 0;
+    UInt    skipped;
+    UInt    repeats  = REGRESS_REPEATS;
+    double  percent  = REGRESS_PERCENT;
+    double  best, pass, start, base;
+    bool    golden   = false;
+    bool    baseline = false;
+    bool    timed    = true;
+    
+    /* first scan arguments for flags */
+    for (t = 1; t < argc; t++) {
+        if (argv[t][0] == '-' && argv[t][1]){
+            switch (argv[t][1]) {
+            case 'h':
+                print_usage();
+                exit(0);
+            case 'g':
+                golden = true;
+                break;
+            case 'b':
+                baseline = true;
+                break;
+            case 'n':
+                repeats = atoi(argv[t] + 2);
+                break;
+            case 'x':
+                percent = atof(argv[t] + 2);
+                break;
+            }
+        } else files++;
+    }
+    
+    if (!repeats) repeats = 1;
+    
+    /* the corpus, graphs of the files followed by the generated ones */
+    
+    i = allocateGraphIterator(s);
+    if (files) initGraphIteratorWithFiles(i, argc - 1, argv + 1);
+    else       initGraphIteratorWithFile(i, REGRESS_GRAPHS);
+    
+    while (loadNextGraph(i, &g, s)) add_graph(&rg, &n, g, s);
+    releaseGraphIterator(i);
+    
+    for (rc = corpus; rc->family && stat == STATUS_OK; rc++) {
+        g = generateGraph(rc->family, rc->a, rc->b, rc->radius, 
+                          REGRESS_SEED, s);
+        if (g) add_graph(&rg, &n, g, s);
+    }
+    
+    if (stat != STATUS_OK || !n) {
+        fprintf(stderr, "hc_regress: could not build the corpus.\n");
+        return 1;
+    }
+    
+    if (golden) {
+        if (!(f = fopen(REGRESS_GOLDEN, "w"))) {
+            fprintf(stderr, "hc_regress: cannot write %s.\n", 
+                    REGRESS_GOLDEN);
+            return 1;
+        }
+        fprintf(f, "# Hamilton cycle counts and the answers of the "
+                   "queries of hc_regress,\n# regenerate with "
+                   "'hc_regress -g'\n");
+        for (k = 0; k < n; k++) {
+            for (a = 0; a < ANSWER_COUNT; a++) {
+                for (en = engines; en->answer != a; en++);
+                result = run_engine(en, rg[k].graph, &c, s);
+                if (result == HC_SEARCH_UNDECIDED) break;
+                rg[k].answers[a] = (ULongLong)c;
+            }
+            if (a < ANSWER_COUNT) {
+                fprintf(stderr, "hc_regress: %s was not answered by %s.\n", 
+                        rg[k].graph->name, en->name);
+                failures++;
+                continue;
+            }
+            fprintf(f, "%s", rg[k].graph->name);
+            for (a = 0; a < ANSWER_COUNT; a++) 
+                fprintf(f, "\t%" c_PF_ULongLong, rg[k].answers[a]);
+            fprintf(f, "\n");
+        }
+        fclose(f);
+        return failures != 0;
+    }
+    
+    if (!read_golden(REGRESS_GOLDEN, rg, n)) {
+        fprintf(stderr, "hc_regress: cannot read %s, create it with "
+                        "'hc_regress -g'.\n", REGRESS_GOLDEN);
+        return 1;
+    }
+    
+    for (k = 0; k < n; k++) {
+        if (!rg[k].known) {
+            printf("FAIL %s: no stored count\n", rg[k].graph->name);
+            failures++;
+        }
+    }
+    
+    f = NULL;
+    if (baseline && !(f = fopen(REGRESS_BASELINE, "w"))) {
+        fprintf(stderr, "hc_regress: cannot write %s.\n", REGRESS_BASELINE);
+        return 1;
+    }
+    
+    printf("%-18s %7s %10s %10s %8s\n", "engine", "skipped", "seconds", 
+           "baseline", "change");
+    
+    /* the answers are checked on the first pass, the fastest pass of
+       each engine is compared with the baseline.  Graphs beyond the size
+       limits of an engine are skipped and counted in the table. */
+    
+    for (en = engines; en->name && stat == STATUS_OK; en++) {
+        best    = 0;
+        skipped = 0;
+        
+        for (run = 0; run < repeats; run++) {
+            start = monotonicSeconds();
+            
+            for (k = 0; k < n; k++) {
+                if (!engine_applies(en, rg[k].graph, s)) {
+                    if (!run) skipped++;
+                    continue;
+                }
+                result = run_engine(en, rg[k].graph, &c, s);
+                if (run || !rg[k].known) continue;
+                
+                if (result == HC_SEARCH_UNDECIDED) {
+                    printf("FAIL %s on %s: undecided\n", en->name, 
+                           rg[k].graph->name);
+                    failures++;
+                } else if (!answer_matches(en, c, 
+                                           rg[k].answers[en->answer])) {
+                    buf[write_usignedhugeval_str(buf, c)] = '\0';
+                    printf("FAIL %s on %s: %s, expected %" c_PF_ULongLong 
+                           "\n", en->name, rg[k].graph->name, buf, 
+                           rg[k].answers[en->answer]);
+                    failures++;
+                }
+            }
+            
+            pass = monotonicSeconds() - start;
+            if (!run || pass < best) best = pass;
+        }
+        
+        if (f) {
+            fprintf(f, "%s\t%.6f\n", en->name, best);
+            printf("%-18s %7u %10.4f\n", en->name, skipped, best);
+            continue;
+        }
+        
+        if ((base = read_baseline(REGRESS_BASELINE, en->name)) < 0) {
+            printf("%-18s %7u %10.4f %10s\n", en->name, skipped, best, "-");
+            timed = false;
+            continue;
+        }
+        
+        printf("%-18s %7u %10.4f %10.4f %+7.1f%%\n", en->name, skipped, 
+               best, base, base > 0 ? 100 * (best - base) / base : 0.0);
+        
+        if (best > REGRESS_NOISE && best > base * (1 + percent / 100)) {
+            printf("FAIL %s: %.1f%% slower than the baseline\n", 
+                   en->name, 100 * (best - base) / base);
+            failures++;
+        }
+    }
+    
+    if (f) fclose(f);
+    else if (!timed) 
+        printf("\nNo baseline for some engines, timing not checked "
+               "(create one with 'hc_regress -b').\n");
+    
+    printf("\n%u graphs, %u failures.\n", n, failures);
+    
+    for (k = 0; k < n; k++) releaseGraph(rg[k].graph);
+    free(rg);
+    
+    return failures != 0 || stat != STATUS_OK;
+}
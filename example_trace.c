@@ -0,0 +1,244 @@
+/* Hamiltonian Cycle Tool.
+
+Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+*/
+
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "Arch.h"
+
+#define COPYRIGHT "Copyright (C) 2009 Andrew Chalaturnyk and William Kocay.\n\n"\
+"This program is free software: you can redistribute it and/or modify\n"\
+"it under the terms of the GNU General Public License as published by\n"\
+"the Free Software Foundation, either version 3 of the License, or\n"\
+"(at your option) any later version.\n"\
+"\n"\
+"This program is distributed in the hope that it will be useful,\n"\
+"but WITHOUT ANY WARRANTY; without even the implied warranty of\n"\
+"MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the\n"\
+"GNU General Public License for more details.\n"\
+"\n"\
+"You should have received a copy of the GNU General Public License\n"\
+"along with this program.  If not, see <http://www.gnu.org/licenses/>.\n"
+
+#define PROFILE_BINS  100
+#define LINE_LENGTH   1024
+
+/*! An event of a trace dump, see writeHCTrace. */
+
+typedef struct trace_event {
+    double  time;
+    char    type;
+    UInt    depth;
+    UInt    vertex;
+} TraceEvent;
+
+/*! An anchor on the flame graph stack. */
+
+typedef struct trace_frame {
+    UInt    depth;
+    UInt    vertex;
+} TraceFrame;
+
+static void
+print_usage()
+{
+	puts(COPYRIGHT);
+	puts("This program turns a tape event trace written by 'hc_count -d' "
+         "into a\ndepth over time profile or a flame graph stack file.\n");
+	puts("Usage: hc_trace [-f] [-b<bins>] [file]\n");
+    puts("Flags:\n\t-h\thelp\n"
+         "\t-b\tNumber of time intervals of the profile (eg. -b500).\n"
+         "\t-f\tWrite folded stacks of anchor vertices weighted by\n"
+         "\t\tnanoseconds, the input of flamegraph.pl.\n");
+}
+
+/*! Read the events of a dump, the graph name is taken from the first 
+comment line.  Returns the number of events read into *ev. */
+
+static UInt
+read_trace(FILE *f, TraceEvent **ev, char *name)
+{
+    TraceEvent *a = NULL, *b;
+    char        line[LINE_LENGTH];
+    UInt        n = 0, size = 0;
+    
+    strcpy(name, "hc");
+    
+    while (fgets(line, LINE_LENGTH, f)) {
+        if (line[0] == '#') {
+            if (n == 0 && strncmp(line, "# hc trace", 10)) {
+                line[strcspn(line, "\n")] = '\0';
+                strcpy(name, line + 2);
+            }
+            continue;
+        }
+        
+        if (n == size) {
+            size = size ? 2 * size : 4096;
+            if (!(b = realloc(a, size * sizeof(TraceEvent)))) break;
+            a = b;
+        }
+        
+        if (sscanf(line, "%lf %c %u %u", &a[n].time, &a[n].type, 
+                   &a[n].depth, &a[n].vertex) == 4) n++;
+    }
+    
+    *ev = a;
+    return n;
+}
+
+/*! Minimum, mean and maximum tape depth of the events in each of bins
+equal intervals of the traced time. */
+
+static void
+write_profile(TraceEvent *ev, UInt n, UInt bins)
+{
+    double  t0 = ev[0].time;
+    double  w  = (ev[n - 1].time - t0) / bins;
+    double  sum;
+    UInt    i, j, lo, hi, count;
+    
+    printf("time\tmin\tmean\tmax\tevents\n");
+    
+    for (i = j = 0; i < bins; i++) {
+        lo    = UInt_MAX;
+        hi    = 0;
+        sum   = 0;
+        count = 0;
+        
+        while (j < n && (i == bins - 1 || ev[j].time < t0 + (i + 1) * w)) {
+            if (ev[j].depth < lo) lo = ev[j].depth;
+            if (ev[j].depth > hi) hi = ev[j].depth;
+            sum += ev[j].depth;
+            count++;
+            j++;
+        }
+        
+        if (count) printf("%.6f\t%u\t%.1f\t%u\t%u\n", t0 + i * w, lo, 
+                          sum / count, hi, count);
+    }
+}
+
+static void
+print_stack(char *name, TraceFrame *st, UInt top, ULongLong ns)
+{
+    UInt i;
+    
+    if (!ns) return;
+    
+    printf("%s", name);
+    for (i = 0; i < top; i++) printf(";v%u", st[i].vertex);
+    printf(" %" c_PF_ULongLong "\n", ns);
+}
+
+/*! Folded stacks, one frame per anchor on the tape.  The time up to the
+next event is charged to the stack of anchors that is current, runs of
+events that leave the stack alone are merged into one line. */
+
+static void
+write_folded(TraceEvent *ev, UInt n, char *name)
+{
+    TraceFrame *st;
+    UInt        i, top = 0;
+    ULongLong   ns = 0;
+    
+    /* tape depth bounds the number of anchors */
+    
+    for (i = 0; i < n; i++) if (ev[i].depth + 1 > top) top = ev[i].depth + 1;
+    if (!(st = malloc(top * sizeof(TraceFrame)))) return;
+    
+    /* frames are not separated by ';' inside a graph name */
+    
+    for (i = 0; name[i]; i++) if (name[i] == ';') name[i] = ',';
+    
+    for (i = top = 0; i < n; i++) {
+        if (ev[i].type == 'A' || ev[i].type == 'U') {
+            print_stack(name, st, top, ns);
+            ns = 0;
+            
+            /* an anchor replaces the anchors at or above its depth, an 
+               unwind to depth k leaves the anchor placed at k - 1 */
+            
+            while (top && st[top - 1].depth >= ev[i].depth) top--;
+            
+            if (ev[i].type == 'A') {
+                st[top].depth  = ev[i].depth;
+                st[top].vertex = ev[i].vertex;
+                top++;
+            }
+        }
+        
+        if (i + 1 < n) 
+            ns += (ULongLong)((ev[i + 1].time - ev[i].time) * 1e9 + 0.5);
+    }
+    
+    print_stack(name, st, top, ns);
+    free(st);
+}
+
+int main(int argc, char ** argv)
+{
+    TraceEvent *ev;
+    FILE   *f     = stdin;
+    char    name[LINE_LENGTH];
+    UInt    t, n;
+    UInt    bins  = PROFILE_BINS;
+    bool    flame = false;
+    
+    /* first scan arguments for flags */
+    for (t = 1; t < argc; t++) {
+        if (argv[t][0] == '-' && argv[t][1]){
+            switch (argv[t][1]) {
+            case 'h':
+                print_usage();
+                exit(0);
+            case 'b':
+                bins = atoi(argv[t] + 2);
+                break;
+            case 'f':
+                flame = true;
+                break;
+            }
+        } else if (!(f = fopen(argv[t], "r"))) {
+            fprintf(stderr, "hc_trace: cannot read %s\n", argv[t]);
+            return 1;
+        }
+    }
+    
+    if (!bins) bins = 1;
+    
+    n = read_trace(f, &ev, name);
+    if (f != stdin) fclose(f);
+    
+    if (!n) {
+        fprintf(stderr, "hc_trace: no events, was hc_count built with "
+                        "'make trace'?\n");
+        free(ev);
+        return 1;
+    }
+    
+    if (flame) write_folded(ev, n, name);
+    else       write_profile(ev, n, bins);
+    
+    free(ev);
+    return 0;
+}